@@ -70,11 +70,8 @@ static void BeginProfile(void);
 
 struct profiler {
     profile_anchor Anchors[4096];
-    profiler() {
-        BeginProfile();
-        CPUFreq = EstimateCPUTimerFreq();
-    }
-    uint64_t CPUFreq;
+    profiler() { BeginProfile(); }
+    uint64_t CPUFreq{0}; // Calibrated on the first report, the estimate busy waits for 100ms
     uint64_t StartTSC{0};
     uint64_t EndTSC{0};
 };
@@ -182,6 +179,9 @@ inline char *EndAndPrintProfile() {
     GlobalProfiler.EndTSC = ReadCPUTimer();
     memset(profile_output, 0, sizeof(profile_output));
     uint64_t TotalCPUElapsed = GlobalProfiler.EndTSC - GlobalProfiler.StartTSC;
+    if (!GlobalProfiler.CPUFreq) {
+        GlobalProfiler.CPUFreq = EstimateCPUTimerFreq();
+    }
     if (GlobalProfiler.CPUFreq) {
         std::sprintf(profile_output, " Total time : % 0.4fms(CPU freq % llu)\n", 1000.0 * static_cast<double>(TotalCPUElapsed) / static_cast<double>(GlobalProfiler.CPUFreq),
                      GlobalProfiler.CPUFreq);
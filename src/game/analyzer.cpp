@@ -5,6 +5,7 @@
 #include "bitboard.hpp"
 #include "board.hpp"
 #include "move.hpp"
+#include "movegen.hpp"
 #include "profiler.hpp"
 
 #ifndef TimeFunction
@@ -12,7 +13,6 @@
 #endif
 
 namespace game {
-alignas(64) const MagicBoards MAGIC_BOARD = detail::init_magic_boards();
 bool analyzer_is_pawn_attacking(const Board *board, const SquareIndex index, const Color attacker) {
     return MAGIC_BOARD.pawn_attackers[attacker][index] & board->pieces_by_type[PAWN] & board->pieces_by_color[attacker];
 }
@@ -25,22 +25,23 @@ bool analyzer_is_king_attacking(const Board *board, const SquareIndex index, con
     return MAGIC_BOARD.king_attackers[index] & board->pieces_by_type[KING] & board->pieces_by_color[attacker];
 }
 
+// Reverse lookups: a slider of the type on the square sees exactly the sliders of that type attacking it
 bool analyzer_is_rook_attacking(const Board *board, const SquareIndex index, const Color attacker) {
     const BitBoard occ = board->pieces_by_type[ANY];
     const BitBoard rooks = board->pieces_by_type[ROOK] & board->pieces_by_color[attacker];
-    return bitboard_get(MAGIC_BOARD.slider_attacks<ROOK>(occ, rooks), index);
+    return MAGIC_BOARD.slider_attacks<ROOK>(occ, index) & rooks;
 }
 
 bool analyzer_is_bishop_attacking(const Board *board, const SquareIndex index, const Color attacker) {
     const BitBoard occ = board->pieces_by_type[ANY];
     const BitBoard bishops = board->pieces_by_type[BISHOP] & board->pieces_by_color[attacker];
-    return bitboard_get(MAGIC_BOARD.slider_attacks<BISHOP>(occ, bishops), index);
+    return MAGIC_BOARD.slider_attacks<BISHOP>(occ, index) & bishops;
 }
 
 bool analyzer_is_queen_attacking(const Board *board, const SquareIndex index, const Color attacker) {
     const BitBoard occ = board->pieces_by_type[ANY];
     const BitBoard queens = board->pieces_by_type[QUEEN] & board->pieces_by_color[attacker];
-    return bitboard_get(MAGIC_BOARD.slider_attacks<QUEEN>(occ, queens), index);
+    return MAGIC_BOARD.slider_attacks<QUEEN>(occ, index) & queens;
 }
 
 bool analyzer_is_queen_attacking([[maybe_unused]] const Board *board, const SquareIndex index, Color, const SquareIndex origin) {
@@ -84,142 +85,115 @@ bool analyzer_is_bishop_attacking(const Board *board, const SquareIndex index, C
 
 bool analyzer_is_cell_under_attack_by_color(const Board *board, const int32_t row, const int32_t col, const Color attacker) {
     TimeFunction;
-    const SquareIndex cell = Board::square_index(row, col);
-    return analyzer_is_knight_attacking(board, cell, attacker) || analyzer_is_king_attacking(board, cell, attacker) || analyzer_is_pawn_attacking(board, cell, attacker) ||
-           analyzer_is_rook_attacking(board, cell, attacker) || analyzer_is_bishop_attacking(board, cell, attacker) || analyzer_is_queen_attacking(board, cell, attacker);
+    return attackers_to(*board, Board::square_index(row, col), board->pieces_by_type[ANY]) & board->pieces_by_color[attacker];
 }
 
 // Pawn moves needs further check in case they are pinners
-static void analyzer_get_pawn_moves(const Board *board, const Piece, const int32_t row, const int32_t col, const Color enemy, AvailableMoves &moves) {
+template <Color Us> static void analyzer_get_pawn_moves(const Board *board, const SquareIndex sq, AvailableMoves &moves) {
     TimeFunction;
+    constexpr Color enemy = ~Us;
+    constexpr int32_t up = Us == PIECE_WHITE ? BLACK_DIRECTION : WHITE_DIRECTION; // Towards the enemy side
     const BitBoard empty = board->pieces_by_type[EMPTY];
-    const BitBoard enemy_pieces = board->pieces_by_color[enemy];
     const BitBoard en_passant_rank = MAGIC_BOARD.en_passant_conversion_table[enemy][board->current_state->en_passant_index + 1];
-    const BitBoard pawn_attacks = MAGIC_BOARD.pawn_attacks[~enemy][Board::square_index(row, col)];
-    const BitBoard pawn_moves = MAGIC_BOARD.pawn_moves[~enemy][Board::square_index(row, col)];
-    const int32_t inc = RowIncrement(~enemy);
-    const int32_t one_sq = (row + inc) * 8 + col;
-    const BitBoard one_bb = BitBoard{1} << one_sq;
-    const BitBoard first = one_bb & empty;
-    const BitBoard guard = BitBoard{0} - BitBoard{first >> one_sq & 1ULL};
+    const BitBoard pawn_attacks = MAGIC_BOARD.pawn_attacks[Us][sq];
+    const BitBoard pawn_moves = MAGIC_BOARD.pawn_moves[Us][sq];
+    const BitBoard first = bitboard_shift<up>(bitboard_from_squares(sq)) & empty;
+    const BitBoard guard = BitBoard{0} - BitBoard{first != 0}; // The double push needs the first square free too
     moves.bits |= first;
     moves.bits |= pawn_moves & empty & guard;
-    moves.bits |= pawn_attacks & enemy_pieces;
+    moves.bits |= pawn_attacks & board->pieces_by_color[enemy];
     moves.bits |= pawn_attacks & en_passant_rank;
 }
 
 // Castles need to further check for attacks on the king's path and current check status.
-static void analyzer_get_king_moves(const Board *board, const Piece, const int32_t row, const int32_t col, const Color enemy, AvailableMoves &moves) {
+template <Color Us> static void analyzer_get_king_moves(const Board *board, const SquareIndex sq, AvailableMoves &moves) {
     TimeFunction;
-    const BitBoard king_attacks = MAGIC_BOARD.king_attacks[Board::square_index(row, col)]; // King attacks are in a table (All neighbor cells)
-    const Color side = ~enemy;                                                             // Friendly color
-    const BitBoard empty = board->pieces_by_type[EMPTY];                                   // Where the squares are empty.
-    const BitBoard ks_between = MAGIC_BOARD.castle_king_empty[std::to_underlying(side)];   // The king side squares that need to be empty
-    const BitBoard ks_dest = MAGIC_BOARD.castle_king_dest[std::to_underlying(side)];       // The king side destination squares
-    const BitBoard qs_between = MAGIC_BOARD.castle_queen_empty[std::to_underlying(side)];  // The queen side squares that need to be empty
-    const BitBoard qs_dest = MAGIC_BOARD.castle_queen_dest[std::to_underlying(side)];      // The queen side destination squares
+    const BitBoard king_attacks = MAGIC_BOARD.king_attacks[sq];         // King attacks are in a table (All neighbor cells)
+    const BitBoard empty = board->pieces_by_type[EMPTY];                 // Where the squares are empty.
+    const BitBoard ks_between = MAGIC_BOARD.castle_king_empty[Us];       // The king side squares that need to be empty
+    const BitBoard ks_dest = MAGIC_BOARD.castle_king_dest[Us];           // The king side destination squares
+    const BitBoard qs_between = MAGIC_BOARD.castle_queen_empty[Us];      // The queen side squares that need to be empty
+    const BitBoard qs_dest = MAGIC_BOARD.castle_queen_dest[Us];          // The queen side destination squares
 
     moves.bits |= static_cast<int32_t>((empty & qs_between) == qs_between) * qs_dest & board->current_state->castle_rights_bit; // Are the squares empty and have the castle-rights?
     moves.bits |= static_cast<int32_t>((empty & ks_between) == ks_between) * ks_dest & board->current_state->castle_rights_bit; // Are the squares empty and have the castle-rights?
-    moves.bits |= king_attacks & (board->pieces_by_color[enemy] | board->pieces_by_type[EMPTY]); // Just the king attacks. The move is available if the dest. Cell is enemy or empty
-}
-
-// Knight moves need further check in case they are pinners
-static void analyzer_get_knight_moves(const Board *board, const Piece, const int32_t row, const int32_t col, const Color enemy, AvailableMoves &moves) {
-    TimeFunction;
-    moves.bits |= MAGIC_BOARD.knight_attackers[Board::square_index(row, col)] & (board->pieces_by_color[enemy] | board->pieces_by_type[EMPTY]); // Knight moves are just attacks
+    moves.bits |= king_attacks & ~board->pieces_by_color[Us]; // Just the king attacks. The move is available if the dest. Cell is enemy or empty
 }
 
 /*
- Bishop, Rook and Queen moves need further check in case they are pinners.
- The tables mark available squares until the first occupied square (including it) as occ does not discriminate color of pieces on it, so
+ Knight, Bishop, Rook and Queen moves need further check in case they are pinners.
+ The slider tables mark available squares until the first occupied square (including it) as occ does not discriminate color of pieces on it, so
  we need to remove the friendly pieces from the attacks after getting the attacks
 */
-static void analyzer_get_bishop_moves(const Board *board, const Piece, const int32_t row, const int32_t col, const Color enemy, AvailableMoves &moves) {
+template <SliderBackend B, PieceType T, Color Us> static void analyzer_get_piece_moves(const Board *board, const SquareIndex sq, AvailableMoves &moves) {
     TimeFunction;
     const BitBoard occ = board->pieces_by_type[ANY];
-    BitBoard bishop_attacks = MAGIC_BOARD.slider_attacks<BISHOP>(occ, Board::square_index(row, col));
-    bishop_attacks &= ~board->pieces_by_color[~enemy]; // Remove the friendly pieces from the attacks
-    moves.bits |= bishop_attacks;
+    BitBoard attacks = 0;
+    if constexpr (T == KNIGHT) {
+        attacks = MAGIC_BOARD.knight_attacks[sq];
+    } else {
+        attacks = MAGIC_BOARD.slider_attacks<T, B>(occ, sq);
+    }
+    moves.bits |= attacks & ~board->pieces_by_color[Us]; // Remove the friendly pieces from the attacks
 }
 
-/*
- Bishop, Rook and Queen moves need further check in case they are pinners.
- The tables mark available squares until the first occupied square (including it) as occ does not discriminate color of pieces on it, so
- we need to remove the friendly pieces from the attacks after getting the attacks
-*/
-static void analyzer_get_rook_moves(const Board *board, const Piece, const int32_t row, const int32_t col, const Color enemy, AvailableMoves &moves) {
+// One switch on the piece, color included, picks the specialized helper
+template <SliderBackend B> static AvailableMoves analyzer_pseudo_legal_moves(const Board *board, const int32_t row, const int32_t col) {
     TimeFunction;
-    const BitBoard occ = board->pieces_by_type[ANY];
-    BitBoard rook_attacks = MAGIC_BOARD.slider_attacks<ROOK>(occ, Board::square_index(row, col));
-    rook_attacks &= ~board->pieces_by_color[~enemy]; // Remove the friendly pieces from the attacks
-    moves.bits |= rook_attacks;
+    const auto sq = Board::square_index(row, col);
+    AvailableMoves moves(sq);
+    switch (board->pieces[sq]) {
+    case WHITE_PAWN  : analyzer_get_pawn_moves<PIECE_WHITE>(board, sq, moves); break;
+    case WHITE_KNIGHT: analyzer_get_piece_moves<B, KNIGHT, PIECE_WHITE>(board, sq, moves); break;
+    case WHITE_BISHOP: analyzer_get_piece_moves<B, BISHOP, PIECE_WHITE>(board, sq, moves); break;
+    case WHITE_ROOK  : analyzer_get_piece_moves<B, ROOK, PIECE_WHITE>(board, sq, moves); break;
+    case WHITE_QUEEN : analyzer_get_piece_moves<B, QUEEN, PIECE_WHITE>(board, sq, moves); break;
+    case WHITE_KING  : analyzer_get_king_moves<PIECE_WHITE>(board, sq, moves); break;
+    case BLACK_PAWN  : analyzer_get_pawn_moves<PIECE_BLACK>(board, sq, moves); break;
+    case BLACK_KNIGHT: analyzer_get_piece_moves<B, KNIGHT, PIECE_BLACK>(board, sq, moves); break;
+    case BLACK_BISHOP: analyzer_get_piece_moves<B, BISHOP, PIECE_BLACK>(board, sq, moves); break;
+    case BLACK_ROOK  : analyzer_get_piece_moves<B, ROOK, PIECE_BLACK>(board, sq, moves); break;
+    case BLACK_QUEEN : analyzer_get_piece_moves<B, QUEEN, PIECE_BLACK>(board, sq, moves); break;
+    case BLACK_KING  : analyzer_get_king_moves<PIECE_BLACK>(board, sq, moves); break;
+    default          : break;
+    }
+    return moves;
 }
 
-/*
- Bishop, Rook and Queen moves need further check in case they are pinners.
- The tables mark available squares until the first occupied square (including it) as occ does not discriminate color of pieces on it, so
- we need to remove the friendly pieces from the attacks after getting the attacks
-*/
-static void analyzer_get_queen_moves(const Board *board, const Piece, const int32_t row, const int32_t col, const Color enemy, AvailableMoves &moves) {
-    TimeFunction;
-    const BitBoard occ = board->pieces_by_type[ANY];
-    BitBoard queen_attacks = MAGIC_BOARD.slider_attacks<QUEEN>(occ, Board::square_index(row, col));
-    queen_attacks &= ~board->pieces_by_color[~enemy]; // Remove the friendly pieces from the attacks
-    moves.bits |= queen_attacks;
+SLIDER_PEXT_ENTRY static AvailableMoves analyzer_pseudo_legal_moves_pext(const Board *board, const int32_t row, const int32_t col) {
+    return analyzer_pseudo_legal_moves<SLIDER_PEXT>(board, row, col);
 }
 
 AvailableMoves analyzer_get_pseudo_legal_moves_for_piece(const Board *board, const int32_t row, const int32_t col) {
-    TimeFunction;
-    using enum PieceType;
-    AvailableMoves moves(Board::get_index(row, col));
-    const auto piece = board->pieces[Board::get_index(row, col)];
-    const auto enemy_color = chess_piece_other_color(PIECE_COLOR(piece));
-    switch (PIECE_TYPE(piece)) {
-    case PAWN  : analyzer_get_pawn_moves(board, piece, row, col, enemy_color, moves); break;
-    case KNIGHT: analyzer_get_knight_moves(board, piece, row, col, enemy_color, moves); break;
-    case BISHOP: analyzer_get_bishop_moves(board, piece, row, col, enemy_color, moves); break;
-    case ROOK  : analyzer_get_rook_moves(board, piece, row, col, enemy_color, moves); break;
-    case QUEEN : analyzer_get_queen_moves(board, piece, row, col, enemy_color, moves); break;
-    case KING  : analyzer_get_king_moves(board, piece, row, col, enemy_color, moves); break;
-    default    : break;
+    switch (slider_backend) {
+    case SLIDER_PEXT        : return analyzer_pseudo_legal_moves_pext(board, row, col);
+    case SLIDER_MAGIC_DIRECT: return analyzer_pseudo_legal_moves<SLIDER_MAGIC_DIRECT>(board, row, col);
+    default                 : return analyzer_pseudo_legal_moves<SLIDER_MAGIC>(board, row, col);
     }
-    return moves;
 }
 
+// The generators work for the side to move, these queries take either color.
+// The en passant square always belongs to the side to move, so it is hidden while the other side is asked about,
+// and the cached check info is worked out again for the color asked about.
+template <typename Query> static auto analyzer_as_side_to_move(Board *board, const Color color, Query query) {
+    if (color == board->side_to_move) {
+        return query(*board);
+    }
+    const BoardState state = *board->current_state;
+    board->side_to_move = color;
+    board->current_state->en_passant_index = EN_PASSANT_INVALID_INDEX;
+    board_update_check_info(*board, *board->current_state, color);
+    const auto result = query(*board);
+    board->side_to_move = ~color;
+    *board->current_state = state;
+    return result;
+}
+
+// Castles, en passant and pins all go through the same bitboard test as the generators, with the cached check info
 static bool analyzer_is_move_legal(Board *board, const Move &move) {
     TimeFunction;
     const auto friendly = PIECE_COLOR(board->pieces[move.get_origin()]);
-
-    if (move.is_castle()) {
-        if (analyzer_is_color_in_check(board, friendly)) {
-            return false;
-        }
-        if (move.king_side_castle()) {
-            for (const auto sq : MAGIC_BOARD.castle_king_squares[std::to_underlying(friendly)]) {
-                if (analyzer_is_cell_under_attack_by_color(board, Board::get_row(sq), Board::get_col(sq), ~friendly)) {
-                    return false;
-                }
-            }
-        } else {
-            // B1 and B1 can be under attack
-            for (int i = 0; i < 2; i++) {
-                const auto sq = MAGIC_BOARD.castle_queen_squares[std::to_underlying(friendly)][i];
-                if (analyzer_is_cell_under_attack_by_color(board, Board::get_row(sq), Board::get_col(sq), ~friendly)) {
-                    return false;
-                }
-            }
-        }
-    } else {
-        BoardState state{};
-        board->move_stateless(move, state);
-        if (analyzer_is_color_in_check(board, friendly)) {
-            board->undo_stateless(state);
-            return false;
-        }
-        board->undo_stateless(state);
-    }
-    return true;
+    return analyzer_as_side_to_move(board, friendly, [move](const Board &b) { return is_legal_move(b, move); });
 }
 
 static bool analyzer_is_move_legal(Board *board, const SimpleMove &move, PromotionPieceType promotion_type = PROMOTION_QUEEN) {
@@ -244,17 +218,18 @@ AvailableMoves analyzer_filter_legal_moves(Board *board, const AvailableMoves mo
 
 bool analyzer_is_color_in_check(Board *board, const Color color) {
     TimeFunction;
-    const int32_t index = bitboard_index(board->pieces_by_type[KING] & board->pieces_by_color[color]);
-    const int32_t kr = Board::get_row(index);
-    const int32_t kc = Board::get_col(index);
-    return analyzer_is_cell_under_attack_by_color(board, kr, kc, chess_piece_other_color(color));
+    if (color == board->side_to_move) {
+        return board->current_state->checkers != 0;
+    }
+    const auto king = static_cast<SquareIndex>(bitboard_index(board->pieces_by_type[KING] & board->pieces_by_color[color]));
+    return attackers_to(*board, king, board->pieces_by_type[ANY]) & board->pieces_by_color[~color];
 }
 
 bool analyzer_is_color_in_checkmate(Board *board, Color color) {
     if (!analyzer_is_color_in_check(board, color)) {
         return false;
     }
-    return analyzer_get_legal_move_count(board, color) == 0;
+    return !analyzer_as_side_to_move(board, color, [](const Board &b) { return has_any_legal_move(b); });
 }
 
 constexpr bool pawn_in_promotion(const Color c, const SquareIndex s) noexcept {
@@ -307,17 +282,11 @@ Move analyzer_get_move_from_simple(const Board *board, const SimpleMove &move, c
 
 int32_t analyzer_get_legal_move_count(Board *board, const Color color) {
     TimeFunction;
-    int32_t count = 0;
-    for (const auto it : BitBoardIterator(board->pieces_by_color[color])) {
-        const auto moves = analyzer_get_pseudo_legal_moves_for_piece(board, it);
-        const auto legal_moves = analyzer_filter_legal_moves(board, moves);
-        count += legal_moves.move_count();
-    }
-    return count;
+    return analyzer_as_side_to_move(board, color, [](const Board &b) { return count_legal_moves(b); });
 }
 
 bool analyzer_get_is_stalemate(Board *board, const Color friendly) {
-    return analyzer_get_legal_move_count(board, friendly) == 0 && !analyzer_is_color_in_checkmate(board, friendly);
+    return !analyzer_is_color_in_check(board, friendly) && !analyzer_as_side_to_move(board, friendly, [](const Board &b) { return has_any_legal_move(b); });
 }
 
 bool analyzer_is_insufficient_material(const Board *board) {
@@ -352,18 +321,31 @@ bool analyzer_is_insufficient_material(const Board *board) {
     return false;
 }
 
+// Direct checks come from the check squares of the moving piece, discovered ones from the enemy king's blockers.
+// Promotions, en passant and castles move a second piece or change the type, so they are made and the new checkers read.
+static bool analyzer_gives_check(Board *board, const Move &move) {
+    const BoardState *const state = board->current_state;
+    const SquareIndex from = move.get_origin_index();
+    const SquareIndex to = move.get_destination_index();
+    if (move.get_special() != Move::MOVE_NONE) {
+        BoardState next{};
+        board->move_stateless(move, next);
+        board->undo_stateless(next);
+        return next.checkers != 0;
+    }
+    if (bitboard_get(state->check_squares[PIECE_TYPE(board->pieces[from])], to)) {
+        return true;
+    }
+    const auto king = static_cast<SquareIndex>(lsb(board->get_piece_bitboard(KING, ~board->side_to_move)));
+    return bitboard_get(state->pinned[~board->side_to_move] & board->pieces_by_color[board->side_to_move], from) && !bitboard_get(MAGIC_BOARD.line_squares[king][from], to);
+}
+
 bool analyzer_move_puts_to_check(Board *board, const Move &move) {
     const auto friendly = PIECE_COLOR(board->pieces[move.get_origin()]);
-    bool result = false;
-    if (analyzer_is_move_legal(board, move)) {
-        BoardState state{};
-        board->move_stateless(move, state);
-        if (analyzer_is_color_in_check(board, ~friendly)) {
-            result = true;
-        }
-        board->undo_stateless(state);
+    if (!analyzer_is_move_legal(board, move)) {
+        return false;
     }
-    return result;
+    return analyzer_as_side_to_move(board, friendly, [move](Board &b) { return analyzer_gives_check(&b, move); });
 }
 
 bool analyzer_move_puts_to_checkmate(Board *board, const Move &move) {
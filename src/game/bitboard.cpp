@@ -4,7 +4,62 @@
 #include "types.hpp"
 #include "unordered_map"
 #include "utils.hpp"
+#if BITBOARD_HAS_PEXT
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
 namespace game {
+#if BITBOARD_HAS_PEXT
+static void cpu_id(const uint32_t leaf, const uint32_t subleaf, gtr::array<uint32_t, 4> &regs) {
+#if defined(_MSC_VER)
+    int r[4]{};
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int32_t i = 0; i < 4; ++i) { regs[i] = static_cast<uint32_t>(r[i]); }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+#endif
+
+bool cpu_has_fast_pext() {
+#if BITBOARD_HAS_PEXT
+    gtr::array<uint32_t, 4> regs{}; // eax, ebx, ecx, edx
+    cpu_id(0, 0, regs);
+    const uint32_t max_leaf = regs[0];
+    const bool amd = regs[1] == 0x68747541 && regs[3] == 0x69746e65 && regs[2] == 0x444d4163; // "AuthenticAMD"
+    if (max_leaf < 7) {
+        return false;
+    }
+    cpu_id(7, 0, regs);
+    if (!(regs[1] & (1U << 8))) {
+        return false; // No BMI2
+    }
+    if (amd) {
+        cpu_id(1, 0, regs);
+        const uint32_t base_family = regs[0] >> 8 & 0xF;
+        const uint32_t family = base_family == 0xF ? base_family + (regs[0] >> 20 & 0xFF) : base_family;
+        return family >= 0x19; // Zen 1 and 2 run PEXT in microcode, dozens of cycles per call
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Without fast PEXT the direct table wins over the compressed one: one dependent load instead of two
+SliderBackend slider_backend = cpu_has_fast_pext() ? SLIDER_PEXT : SLIDER_MAGIC_DIRECT;
+
+bool slider_set_backend(const SliderBackend backend) {
+    if (backend >= SLIDER_BACKEND_COUNT || (backend == SLIDER_PEXT && !cpu_has_fast_pext())) {
+        return false;
+    }
+    slider_backend = backend;
+    return true;
+}
+
 namespace detail {
 static BitBoard sliding_attacks_rook(const SquareIndex sq, const BitBoard occ) noexcept {
     BitBoard attacks = 0;
@@ -189,6 +244,25 @@ static void fill_sliders_magic(MagicBoards &mb) {
             bishop_offset += table_size;
         }
     }
+    for (int32_t i = 0; i < 0x19000; ++i) { mb.rook_direct_table[i] = rook_attack_table[i]; }
+    for (int32_t i = 0; i < 0x1480; ++i) { mb.bishop_direct_table[i] = bishop_attack_table[i]; }
+
+    // PEXT tables, the carry-rippler walks the subsets of the mask in increasing order, which is exactly the PEXT index order
+    for (int32_t sq = A1; sq < SQUARE_COUNT; ++sq) {
+        BitBoard b = 0;
+        int32_t index = 0;
+        do {
+            mb.rook_pext_table[mb.rook_offset[sq] + index++] = sliding_attacks_rook(static_cast<SquareIndex>(sq), b);
+            b = (b - mb.rook_mask[sq]) & mb.rook_mask[sq];
+        } while (b);
+        b = 0;
+        index = 0;
+        do {
+            mb.bishop_pext_table[mb.bishop_offset[sq] + index++] = sliding_attacks_bishop(static_cast<SquareIndex>(sq), b);
+            b = (b - mb.bishop_mask[sq]) & mb.bishop_mask[sq];
+        } while (b);
+    }
+
     // Compress rook unique indexes
     {
         std::unordered_map<BitBoard, gtr::vector<int32_t>> unique_rook_masks;
@@ -313,6 +387,23 @@ MagicBoards init_magic_boards() {
         mb.bishop_mask[sq] = sliding_attacks_bishop(static_cast<SquareIndex>(sq), 0) & ~edges;
     }
 
+    for (int32_t a = 0; a < SQUARE_COUNT; ++a) {
+        const BitBoard a_bb = BitBoard{1} << a;
+        for (int32_t b = 0; b < SQUARE_COUNT; ++b) {
+            const BitBoard b_bb = BitBoard{1} << b;
+            if (a == b) {
+                continue;
+            }
+            if (sliding_attacks_rook(static_cast<SquareIndex>(a), 0) & b_bb) {
+                mb.line_squares[a][b] = (sliding_attacks_rook(static_cast<SquareIndex>(a), 0) & sliding_attacks_rook(static_cast<SquareIndex>(b), 0)) | a_bb | b_bb;
+                mb.between_squares[a][b] = sliding_attacks_rook(static_cast<SquareIndex>(a), b_bb) & sliding_attacks_rook(static_cast<SquareIndex>(b), a_bb);
+            } else if (sliding_attacks_bishop(static_cast<SquareIndex>(a), 0) & b_bb) {
+                mb.line_squares[a][b] = (sliding_attacks_bishop(static_cast<SquareIndex>(a), 0) & sliding_attacks_bishop(static_cast<SquareIndex>(b), 0)) | a_bb | b_bb;
+                mb.between_squares[a][b] = sliding_attacks_bishop(static_cast<SquareIndex>(a), b_bb) & sliding_attacks_bishop(static_cast<SquareIndex>(b), a_bb);
+            }
+        }
+    }
+
     fill_sliders_magic(mb);
     return mb;
 }
@@ -5,8 +5,26 @@
 #include "array.hpp"
 #include "types.hpp"
 
-#if defined(_MSC_VER)
+#if defined(__x86_64__) || defined(_M_X64)
 #include <immintrin.h>
+#define BITBOARD_HAS_PEXT 1
+#else
+#define BITBOARD_HAS_PEXT 0
+#endif
+
+/*
+ Only the PEXT entry points are compiled for BMI2, everything they call is flattened into them.
+ Building a whole translation unit with -mbmi2 would let the linker pick BMI2 copies of shared inline functions.
+*/
+#if BITBOARD_HAS_PEXT && !defined(_MSC_VER)
+#define SLIDER_PEXT_TARGET __attribute__((target("bmi2")))
+#define SLIDER_PEXT_ENTRY __attribute__((target("bmi2"), flatten))
+#elif defined(_MSC_VER)
+#define SLIDER_PEXT_TARGET
+#define SLIDER_PEXT_ENTRY [[msvc::flatten]]
+#else
+#define SLIDER_PEXT_TARGET
+#define SLIDER_PEXT_ENTRY
 #endif
 namespace game {
 using BitBoard = uint64_t;
@@ -37,6 +55,21 @@ inline uint32_t lsb(BitBoard bb) {
 #endif
 }
 
+SLIDER_PEXT_TARGET inline BitBoard bitboard_pext(const BitBoard value, const BitBoard mask) noexcept {
+#if BITBOARD_HAS_PEXT
+    return _pext_u64(value, mask);
+#else
+    BitBoard result = 0;
+    int32_t bit = 0;
+    for (BitBoard m = mask; m; m &= m - 1, ++bit) {
+        if (value & m & (~m + 1)) {
+            result |= BitBoard{1} << bit;
+        }
+    }
+    return result;
+#endif
+}
+
 static constexpr BitBoard RANK_MASK = 0xFFULL;
 
 static constexpr BitBoard BITBOARD_FULL = 0xFFFFFFFFFFFFFFFFULL;
@@ -133,6 +166,9 @@ inline int32_t RowIncrement(const Color c) {
     return row_increments[std::to_underlying(c)];
 }
 
+// Moves every square of the set by a compile time direction, squares leaving the board are dropped
+template <int32_t D> constexpr BitBoard bitboard_shift(const BitBoard b) { return D > 0 ? b << D : b >> -D; }
+
 constexpr int8_t EN_PASSANT_INVALID_INDEX{-1};
 
 struct AvailableMoves {
@@ -150,6 +186,27 @@ struct AvailableMoves {
 
 gtr::large_string print_bitboard(BitBoard board);
 
+enum SliderBackend : uint8_t {
+    SLIDER_MAGIC,        // Magic index into the uint16_t unique indexes, then the small unique table: two dependent loads
+    SLIDER_MAGIC_DIRECT, // Fancy magic index straight into the attack table: one dependent load, bigger footprint
+    SLIDER_PEXT,         // BMI2 PEXT index into a plain table, only where PEXT is fast
+    SLIDER_BACKEND_COUNT
+};
+
+inline const char *slider_backend_to_string(const SliderBackend backend) {
+    static constexpr gtr::array names = {"magic", "direct", "pext"};
+    return names[backend];
+}
+
+// CPUID check for BMI2, excluding the AMD parts where PEXT is microcoded (before Zen 3)
+bool cpu_has_fast_pext();
+
+// Backend used by the dispatching entry points, picked once at startup
+extern SliderBackend slider_backend;
+
+// Fails and keeps the current backend when the CPU cannot run the requested one
+bool slider_set_backend(SliderBackend backend);
+
 struct MagicBoards {
     gtr::array<gtr::array<BitBoard, SQUARE_COUNT + 1>, COLOR_COUNT> en_passant_conversion_table;
     gtr::array<gtr::array<BitBoard, SQUARE_COUNT>, COLOR_COUNT> pawn_attacks;
@@ -169,6 +226,10 @@ struct MagicBoards {
     gtr::array<BitBoard, SQUARE_COUNT> knight_attackers;
     gtr::array<BitBoard, SQUARE_COUNT> king_attackers;
 
+    // Squares strictly between two aligned squares, and the full line through them. Both are empty when the squares are not aligned.
+    gtr::array<gtr::array<BitBoard, SQUARE_COUNT>, SQUARE_COUNT> between_squares;
+    gtr::array<gtr::array<BitBoard, SQUARE_COUNT>, SQUARE_COUNT> line_squares;
+
     BitBoard queen_mask(const SquareIndex sq) const noexcept { return bishop_mask[sq] | rook_mask[sq]; }
 
     gtr::array<BitBoard, SQUARE_COUNT> bishop_mask;
@@ -185,8 +246,24 @@ struct MagicBoards {
     gtr::array<uint16_t, 0x19000> rook_unique_indexes;
     gtr::array<BitBoard, 4900> rook_unique_table;
 
-    template <PieceType T> BitBoard slider_attacks(BitBoard occ, const SquareIndex sq) const noexcept {
-        if constexpr (T == ROOK) {
+    // PEXT of the occupancy is the index inside the square's slice, the slices share the magic offsets
+    gtr::array<BitBoard, 0x1480> bishop_pext_table;
+    gtr::array<BitBoard, 0x19000> rook_pext_table;
+
+    // Attack sets stored at the magic index itself, the uncompressed form of the unique tables
+    gtr::array<BitBoard, 0x1480> bishop_direct_table;
+    gtr::array<BitBoard, 0x19000> rook_direct_table;
+
+    template <PieceType T, SliderBackend B = SLIDER_MAGIC> BitBoard slider_attacks(BitBoard occ, const SquareIndex sq) const noexcept {
+        if constexpr (B == SLIDER_PEXT && T == ROOK) {
+            return rook_pext_table[rook_offset[sq] + bitboard_pext(occ, rook_mask[sq])];
+        } else if constexpr (B == SLIDER_PEXT && T == BISHOP) {
+            return bishop_pext_table[bishop_offset[sq] + bitboard_pext(occ, bishop_mask[sq])];
+        } else if constexpr (B == SLIDER_MAGIC_DIRECT && T == ROOK) {
+            return rook_direct_table[rook_offset[sq] + ((occ & rook_mask[sq]) * rook_magic[sq] >> rook_shift[sq])];
+        } else if constexpr (B == SLIDER_MAGIC_DIRECT && T == BISHOP) {
+            return bishop_direct_table[bishop_offset[sq] + ((occ & bishop_mask[sq]) * bishop_magic[sq] >> bishop_shift[sq])];
+        } else if constexpr (T == ROOK) {
             occ &= rook_mask[sq];   // Apply the mask to the occupancy
             occ *= rook_magic[sq];  // Multiply by the magic number
             occ >>= rook_shift[sq]; // Shift to get the index
@@ -197,18 +274,18 @@ struct MagicBoards {
             occ >>= bishop_shift[sq]; // Shift to get the index
             return bishop_unique_table[bishop_unique_indexes[bishop_offset[sq] + occ]];
         } else if constexpr (T == QUEEN) {
-            return slider_attacks<ROOK>(occ, sq) | slider_attacks<BISHOP>(occ, sq);
+            return slider_attacks<ROOK, B>(occ, sq) | slider_attacks<BISHOP, B>(occ, sq);
         } else {
             Unreachable("Invalid piece type for slider attacks");
         }
     }
 
-    template <PieceType T> BitBoard slider_attacks(const BitBoard occ, BitBoard bb) const noexcept {
+    template <PieceType T, SliderBackend B = SLIDER_MAGIC> BitBoard slider_attacks(const BitBoard occ, BitBoard bb) const noexcept {
         BitBoard attacks = 0;
         while (bb) {
             unsigned idx = lsb(bb);
             const BitBoard lsb = BitBoard{1} << idx;
-            attacks |= slider_attacks<T>(occ, static_cast<SquareIndex>(idx));
+            attacks |= slider_attacks<T, B>(occ, static_cast<SquareIndex>(idx));
             bb ^= lsb;
         }
         return attacks;
@@ -1,4 +1,5 @@
 #include "board.hpp"
+#include <algorithm>
 #include <cmath>
 #include "analyzer.hpp"
 #include "math.hpp"
@@ -36,6 +37,31 @@ void Board::init() {
     current_state->en_passant_index = EN_PASSANT_INVALID_INDEX;
     side_to_move = PIECE_WHITE;
     move_count = 0;
+    current_state->key = zobrist_compute(*this);
+    current_state->eval = eval_compute(*this);
+    board_update_check_info(*this, *current_state, side_to_move);
+    ++version;
+}
+
+Board &Board::operator=(const Board &other) {
+    if (this == &other) {
+        return *this;
+    }
+    pieces = other.pieces;
+    pieces_by_type = other.pieces_by_type;
+    pieces_by_color = other.pieces_by_color;
+    state_history = other.state_history;
+    move_count = other.move_count;
+    side_to_move = other.side_to_move;
+    current_state = state_history.current();
+    // A stateless move in flight lives in caller storage: its state becomes the copy's current one and cannot be undone
+    if (other.current_state != other.state_history.current()) {
+        *current_state = *other.current_state;
+    }
+    current_state->previous = nullptr;
+    // Past both versions, a cache built from either board sees the copy as new
+    version = std::max(version, other.version) + 1;
+    return *this;
 }
 
 [[maybe_unused]] static bool board_can_move_basic(const Board *board, const uint8_t from_index, const uint8_t to_index) {
@@ -55,117 +81,112 @@ void Board::init() {
     return true;
 }
 
-static bool on_corner(const int32_t row, const int32_t col) {
-    static constexpr BitBoard corner_bitboard = bitboard_from_squares<A1, H1, A8, H8>();
-    return bitboard_get(corner_bitboard, row, col);
-}
-
 static void board_undo_castle(Board *board, const Move move) {
     const auto queen_side = static_cast<int>(move.from_col() - move.to_col() > 0);
     static constexpr gtr::array rook_orig_col = {7, 0};
     static constexpr gtr::array rook_castled_col = {5, 3};
-    board->move_piece(move.get_destination_index(), move.get_origin_index());
-    board->move_piece(move.from_row(), rook_castled_col[queen_side], move.from_row(), rook_orig_col[queen_side]);
+    board->move_piece<EVAL_NONE, KEY_NONE>(move.get_destination_index(), move.get_origin_index());
+    board->move_piece<EVAL_NONE, KEY_NONE>(move.from_row(), rook_castled_col[queen_side], move.from_row(), rook_orig_col[queen_side]);
 }
 
-static void update_rights(BoardState &state, Piece piece, const int32_t piece_row, const int32_t piece_col) {
-    static constexpr gtr::array rights_king_on_corner_0{gtr::array{~CASTLE_WHITE_ALL, ~CASTLE_BLACK_ALL}, gtr::array{CASTLE_RIGHTS_ALL, CASTLE_RIGHTS_ALL}};
-    static constexpr gtr::array rights_king_on_corner_7{gtr::array{~CASTLE_WHITE_ALL, ~CASTLE_BLACK_ALL}, gtr::array{CASTLE_RIGHTS_ALL, CASTLE_RIGHTS_ALL}};
-    static constexpr gtr::array rights_king = {rights_king_on_corner_0, rights_king_on_corner_7};
-
-    static constexpr gtr::array rights_rook_on_corner_0{gtr::array{~CASTLE_WHITE_KINGSIDE, ~CASTLE_BLACK_KINGSIDE}, gtr::array{CASTLE_RIGHTS_ALL, CASTLE_RIGHTS_ALL}};
-    static constexpr gtr::array rights_rook_on_corner_7{gtr::array{~CASTLE_WHITE_QUEENSIDE, ~CASTLE_BLACK_QUEENSIDE}, gtr::array{CASTLE_RIGHTS_ALL, CASTLE_RIGHTS_ALL}};
-    static constexpr gtr::array rights_rook = {rights_rook_on_corner_0, rights_rook_on_corner_7};
-
-    static constexpr gtr::array rights_non_relevant_on_corner_0{gtr::array{CASTLE_RIGHTS_ALL, CASTLE_RIGHTS_ALL}, gtr::array{CASTLE_RIGHTS_ALL, CASTLE_RIGHTS_ALL}};
-    static constexpr gtr::array rights_non_relevant_on_corner_7{gtr::array{CASTLE_RIGHTS_ALL, CASTLE_RIGHTS_ALL}, gtr::array{CASTLE_RIGHTS_ALL, CASTLE_RIGHTS_ALL}};
-    static constexpr gtr::array rights_non_relevant = {rights_non_relevant_on_corner_0, rights_non_relevant_on_corner_7};
-
-    static constexpr gtr::array rights_king_bit_on_corner_0{gtr::array{bitboard_from_squares<G8, C8>(), bitboard_from_squares<G1, C1>()}, gtr::array{BITBOARD_FULL, BITBOARD_FULL}};
-    static constexpr gtr::array rights_king_bit_on_corner_7{gtr::array{bitboard_from_squares<G8, C8>(), bitboard_from_squares<G1, C1>()}, gtr::array{BITBOARD_FULL, BITBOARD_FULL}};
-    static constexpr gtr::array rights_king_bit = {rights_king_bit_on_corner_0, rights_king_bit_on_corner_7};
-
-    static constexpr gtr::array rights_rook_bit_on_corner_0{gtr::array{bitboard_from_squares<G8, C1, C8>(), bitboard_from_squares<G1, C1, C8>()},
-                                                            gtr::array{BITBOARD_FULL, BITBOARD_FULL}};
-    static constexpr gtr::array rights_rook_bit_on_corner_7{gtr::array{bitboard_from_squares<G1, G8, C8>(), bitboard_from_squares<G1, G8, C1>()},
-                                                            gtr::array{BITBOARD_FULL, BITBOARD_FULL}};
-    static constexpr gtr::array rights_rook_bit = {rights_rook_bit_on_corner_0, rights_rook_bit_on_corner_7};
-
-    static constexpr gtr::array rights_non_relevant_bit_on_corner_0{gtr::array{BITBOARD_FULL, BITBOARD_FULL}, gtr::array{BITBOARD_FULL, BITBOARD_FULL}};
-    static constexpr gtr::array rights_non_relevant_bit_on_corner_7{gtr::array{BITBOARD_FULL, BITBOARD_FULL}, gtr::array{BITBOARD_FULL, BITBOARD_FULL}};
-    static constexpr gtr::array rights_non_relevant_bit = {rights_non_relevant_bit_on_corner_0, rights_non_relevant_bit_on_corner_7};
-
-    static constexpr gtr::array rights{rights_non_relevant, rights_non_relevant, rights_non_relevant, rights_non_relevant, rights_rook, rights_non_relevant, rights_king};
-
-    static constexpr gtr::array rights_bit{rights_non_relevant_bit, rights_non_relevant_bit, rights_non_relevant_bit, rights_non_relevant_bit,
-                                           rights_rook_bit,         rights_non_relevant_bit, rights_king_bit};
-
-    state.castle_rights &= rights[PIECE_TYPE(piece)][piece_col == 0][on_corner(piece_row, piece_col)][PIECE_COLOR(piece)];
-    state.castle_rights_bit &= rights_bit[PIECE_TYPE(piece)][piece_col == 0][on_corner(piece_row, piece_col)][PIECE_COLOR(piece)];
+// Castle rights are bound to squares: anything leaving or landing on a king or rook origin clears the matching rights
+void board_update_rights(BoardState &state, const SquareIndex origin, const SquareIndex destination) {
+    static constexpr auto rights_bit_mask = [] {
+        gtr::array<BitBoard, SQUARE_COUNT> mask{};
+        for (auto &m : mask) { m = BITBOARD_FULL; }
+        mask[A1] = ~bitboard_from_squares<C1>();
+        mask[H1] = ~bitboard_from_squares<G1>();
+        mask[E1] = ~bitboard_from_squares<C1, G1>();
+        mask[A8] = ~bitboard_from_squares<C8>();
+        mask[H8] = ~bitboard_from_squares<G8>();
+        mask[E8] = ~bitboard_from_squares<C8, G8>();
+        return mask;
+    }();
+
+    state.castle_rights &= CASTLE_RIGHTS_MASK[origin] & CASTLE_RIGHTS_MASK[destination];
+    state.castle_rights_bit &= rights_bit_mask[origin] & rights_bit_mask[destination];
 }
 
-static void apply_move(Board &board, const Move move, BoardState &state) {
+template <EvalPolicy E> void board_apply_move(Board &board, const Move move, BoardState &state) {
     TimeFunction;
     const Piece from_piece = board.pieces[move.get_origin()];
+    const Color mover = PIECE_COLOR(from_piece);
+    state.key ^= ZOBRIST.side ^ ZOBRIST.castle[std::to_underlying(state.castle_rights)] ^ zobrist_en_passant(board, state.en_passant_index, mover);
     state.en_passant_index = EN_PASSANT_INVALID_INDEX; // Reset en passant index
     state.moved_piece = from_piece;
     state.captured_piece = board.pieces[Board::get_index(move.to_row(), move.to_col())];
+    // En passant is a pawn move, so the empty destination square does not matter
+    state.halfmove_clock = PIECE_TYPE(from_piece) == PAWN || PIECE_TYPE(state.captured_piece) != EMPTY ? 0 : state.halfmove_clock + 1;
     if (PIECE_TYPE(from_piece) == PAWN && gtr::abs(move.from_row() - move.to_row()) == 2) {
         state.en_passant_index = static_cast<int8_t>(static_cast<int8_t>(move.get_destination()) + (IS_WHITE(from_piece) ? WHITE_DIRECTION : BLACK_DIRECTION));
     }
-    for (int i = 0; i < 80000; ++i) update_rights(state, from_piece, move.from_row(), move.from_col());
+    board_update_rights(state, move.get_origin_index(), move.get_destination_index());
     switch (move.get_special()) {
     case Move::MOVE_EN_PASSANT: {
         const int32_t captured_row = PIECE_COLOR(from_piece) == PIECE_WHITE ? move.to_row() - 1 : move.to_row() + 1;
         const int32_t captured_col = move.to_col();
         state.captured_piece = board.pieces[Board::get_index(captured_row, captured_col)];
-        board.remove_piece(captured_row, captured_col);
-        board.remove_piece(move.get_origin_index());
-        board.put_piece(from_piece, move.get_destination_index());
+        board.remove_piece<E>(captured_row, captured_col);
+        board.remove_piece<E>(move.get_origin_index());
+        board.put_piece<E>(from_piece, move.get_destination_index());
         break;
     }
     case Move::MOVE_CASTLE: {
         const auto queen_side = static_cast<int>(move.from_col() - move.to_col() > 0);
         static constexpr gtr::array rook_orig_col = {7, 0};
         static constexpr gtr::array rook_castled_col = {5, 3};
-        board.move_piece(move.from_row(), rook_orig_col[queen_side], move.from_row(), rook_castled_col[queen_side]);
-        board.move_piece(move.get_origin_index(), move.get_destination_index());
+        board.move_piece<E>(move.from_row(), rook_orig_col[queen_side], move.from_row(), rook_castled_col[queen_side]);
+        board.move_piece<E>(move.get_origin_index(), move.get_destination_index());
     } break;
     case Move::MOVE_PROMOTION:
         if (PIECE_TYPE(state.captured_piece) != EMPTY) {
-            board.remove_piece(move.get_destination_index());
+            board.remove_piece<E>(move.get_destination_index());
         }
-        board.put_piece(chess_piece_make(move.get_promotion_piece_type(), PIECE_COLOR(board.pieces[move.get_origin()])), move.get_destination_index());
-        board.remove_piece(move.get_origin_index());
+        board.put_piece<E>(chess_piece_make(move.get_promotion_piece_type(), PIECE_COLOR(board.pieces[move.get_origin()])), move.get_destination_index());
+        board.remove_piece<E>(move.get_origin_index());
         break;
     case Move::MOVE_NONE:
     default:
         if (PIECE_TYPE(state.captured_piece) != EMPTY) {
-            board.remove_piece(move.to_row(), move.to_col());
+            board.remove_piece<E>(move.to_row(), move.to_col());
         }
-        board.remove_piece(move.get_origin_index());
-        board.put_piece(from_piece, move.get_destination_index());
+        board.remove_piece<E>(move.get_origin_index());
+        board.put_piece<E>(from_piece, move.get_destination_index());
         break;
     }
+    state.key ^= ZOBRIST.castle[std::to_underlying(state.castle_rights)] ^ zobrist_en_passant(board, state.en_passant_index, ~mover);
 }
 
-void Board::move_stateless(const Move m, BoardState &state) {
+template void board_apply_move<EVAL_NONE>(Board &, Move, BoardState &);
+template void board_apply_move<EVAL_INCREMENTAL>(Board &, Move, BoardState &);
+
+template <EvalPolicy E> void Board::move_stateless(const Move m, BoardState &state) {
     Assert(board_can_move_basic(this, m.get_origin(), m.get_destination()), "Invalid move");
+    // The caller owns the storage, the board only links it so nested moves see the right castle rights and en passant square
+    state = *current_state;
+    state.previous = current_state;
+    current_state = &state;
     state.last_move = m;
-    apply_move(*this, m, state);
+    board_apply_move<E>(*this, m, state);
     side_to_move = ~side_to_move; // Switch sides
+    board_update_check_info(*this, state, side_to_move);
     move_count++;
 }
 
+template void Board::move_stateless<EVAL_NONE>(Move, BoardState &);
+template void Board::move_stateless<EVAL_INCREMENTAL>(Move, BoardState &);
+
 void Board::move(const Move m) {
     Assert(board_can_move_basic(this, m.get_origin(), m.get_destination()), "Invalid move");
     const BoardState current_state_copy = *current_state;
     state_history.push(current_state_copy);
     current_state = state_history.current();
     current_state->last_move = m;
-    apply_move(*this, m, *current_state);
+    board_apply_move(*this, m, *current_state);
     side_to_move = ~side_to_move; // Switch sides
+    board_update_check_info(*this, *current_state, side_to_move);
     move_count++;
+    ++version;
 }
 
 void Board::move(const Move m, AlgebraicMove &out_alg) {
@@ -183,26 +204,46 @@ bool Board::redo() {
 
     const Move &move = state_history.data[state_history.read_index + 1].last_move;
     Assert(board_can_move_basic(this, move.get_origin(), move.get_destination()), "Invalid move");
-    BoardState dummy{};
-    apply_move(*this, move, dummy);
+    // The stored state already holds the result, check info included, replay into a scratch copy so the current key stays untouched
+    BoardState dummy = *current_state;
+    current_state = &dummy;
+    board_apply_move(*this, move, dummy);
     state_history.redo();
     side_to_move = ~side_to_move; // Switch sides
     current_state = state_history.current();
     move_count++;
+    ++version;
     return true;
 }
 
+BoardSnapshot Board::snapshot() const {
+    return BoardSnapshot{pieces, pieces_by_type, pieces_by_color, state_history.read_index, move_count, side_to_move};
+}
+
+void Board::restore(const BoardSnapshot &snapshot) {
+    Assert(snapshot.history_index < state_history.data.size(), "Snapshot is past the end of the timeline");
+    pieces = snapshot.pieces;
+    pieces_by_type = snapshot.pieces_by_type;
+    pieces_by_color = snapshot.pieces_by_color;
+    state_history.read_index = snapshot.history_index;
+    current_state = state_history.current();
+    move_count = snapshot.move_count;
+    side_to_move = snapshot.side_to_move;
+    ++version;
+}
+
 static bool do_undo(Board &board, const Move &move, const BoardState &state) {
     if (move != Move()) {
+        // The previous state still holds its key, so the piece mutators leave every state alone
         if (move.get_special() == Move::MOVE_CASTLE) {
             board_undo_castle(&board, move);
         } else {
-            board.remove_piece(move.get_destination_index());
-            board.put_piece(state.moved_piece, move.get_origin_index());
+            board.remove_piece<EVAL_NONE, KEY_NONE>(move.get_destination_index());
+            board.put_piece<EVAL_NONE, KEY_NONE>(state.moved_piece, move.get_origin_index());
             if (move.get_special() == Move::MOVE_EN_PASSANT) {
-                board.put_piece(state.captured_piece, square_index(move.to_row() + ((PIECE_COLOR(state.moved_piece) == PIECE_WHITE) ? -1 : +1), move.to_col()));
+                board.put_piece<EVAL_NONE, KEY_NONE>(state.captured_piece, square_index(move.to_row() + ((PIECE_COLOR(state.moved_piece) == PIECE_WHITE) ? -1 : +1), move.to_col()));
             } else if (PIECE_TYPE(state.captured_piece) != EMPTY) {
-                board.put_piece(state.captured_piece, move.get_destination_index());
+                board.put_piece<EVAL_NONE, KEY_NONE>(state.captured_piece, move.get_destination_index());
             }
         }
         return true;
@@ -217,6 +258,7 @@ bool Board::undo() {
         current_state = state_history.current();
         side_to_move = ~side_to_move; // Switch sides
         move_count--;
+        ++version;
         return true;
     }
     return false;
@@ -225,6 +267,7 @@ bool Board::undo() {
 bool Board::undo_stateless(const BoardState &state) {
     const Move move = state.last_move;
     if (do_undo(*this, move, state)) {
+        current_state = state.previous;
         side_to_move = ~side_to_move; // Switch sides
         move_count--;
         return true;
@@ -244,11 +287,13 @@ gtr::large_string Board::board_to_string() const {
 void Board::set_position(const Fen &fen) {
     state_history.clear();
     state_history.push({});
+    current_state = state_history.current();
     std::memset(&pieces_by_type, 0, sizeof(pieces_by_type));
     std::memset(&pieces_by_color, 0, sizeof(pieces_by_color));
     std::memset(&pieces, 0, sizeof(pieces));
     side_to_move = fen.turn();
     move_count = fen.fullmove_number() - 1; // FEN fullmove_number starts at 1, we start at 0
+    current_state->halfmove_clock = static_cast<uint16_t>(fen.halfmove_clock());
     current_state->castle_rights = fen.castle_rights();
     current_state->castle_rights_bit |= (current_state->castle_rights & CASTLE_WHITE_KINGSIDE) != std::byte{0} ? bitboard_from_squares<G1>() : 0;
     current_state->castle_rights_bit |= (current_state->castle_rights & CASTLE_WHITE_QUEENSIDE) != std::byte{0} ? bitboard_from_squares<C1>() : 0;
@@ -264,8 +309,53 @@ void Board::set_position(const Fen &fen) {
             put_piece(piece, static_cast<SquareIndex>(sq));
         }
     }
+    current_state->key = zobrist_compute(*this);
+    current_state->eval = eval_compute(*this);
+    board_update_check_info(*this, *current_state, side_to_move);
+    ++version;
+}
+
+SLIDER_PEXT_ENTRY static BitBoard attackers_to_pext(const Board &board, const SquareIndex sq, const BitBoard occ) { return attackers_to<SLIDER_PEXT>(board, sq, occ); }
+
+BitBoard attackers_to(const Board &board, const SquareIndex sq, const BitBoard occ) {
+    switch (slider_backend) {
+    case SLIDER_PEXT        : return attackers_to_pext(board, sq, occ);
+    case SLIDER_MAGIC_DIRECT: return attackers_to<SLIDER_MAGIC_DIRECT>(board, sq, occ);
+    default                 : return attackers_to<SLIDER_MAGIC>(board, sq, occ);
+    }
+}
+
+// Positions set up without a king (tests, editors) simply get no check info for it
+template <SliderBackend B> static void board_check_info(const Board &board, BoardState &state, const Color us) {
+    const BitBoard occ = board.pieces_by_type[ANY];
+    const BitBoard our_king = board.get_piece_bitboard(KING, us);
+    const BitBoard their_king = board.get_piece_bitboard(KING, ~us);
+    state.checkers = our_king ? attackers_to<B>(board, static_cast<SquareIndex>(lsb(our_king)), occ) & board.pieces_by_color[~us] : 0;
+    state.pinned[us] = our_king ? slider_blockers<B>(board, static_cast<SquareIndex>(lsb(our_king)), us) : 0;
+    state.pinned[~us] = their_king ? slider_blockers<B>(board, static_cast<SquareIndex>(lsb(their_king)), ~us) : 0;
+    if (!their_king) {
+        state.check_squares = {};
+        return;
+    }
+    const auto king = static_cast<SquareIndex>(lsb(their_king));
+    state.check_squares[PAWN] = MAGIC_BOARD.pawn_attackers[us][king];
+    state.check_squares[KNIGHT] = MAGIC_BOARD.knight_attacks[king];
+    state.check_squares[BISHOP] = MAGIC_BOARD.slider_attacks<BISHOP, B>(occ, king);
+    state.check_squares[ROOK] = MAGIC_BOARD.slider_attacks<ROOK, B>(occ, king);
+    state.check_squares[QUEEN] = state.check_squares[BISHOP] | state.check_squares[ROOK];
+    state.check_squares[KING] = 0;
+}
+
+SLIDER_PEXT_ENTRY static void board_check_info_pext(const Board &board, BoardState &state, const Color us) { board_check_info<SLIDER_PEXT>(board, state, us); }
+
+void board_update_check_info(const Board &board, BoardState &state, const Color side_to_move) {
+    switch (slider_backend) {
+    case SLIDER_PEXT        : board_check_info_pext(board, state, side_to_move); break;
+    case SLIDER_MAGIC_DIRECT: board_check_info<SLIDER_MAGIC_DIRECT>(board, state, side_to_move); break;
+    default                 : board_check_info<SLIDER_MAGIC>(board, state, side_to_move); break;
+    }
 }
 
-Fen Board::get_fen() const { return Fen::build(pieces, side_to_move, current_state->castle_rights, static_cast<SquareIndex>(current_state->en_passant_index), 0, move_count + 1); }
+Fen Board::get_fen() const { return Fen::build(pieces, side_to_move, current_state->castle_rights, static_cast<SquareIndex>(current_state->en_passant_index), current_state->halfmove_clock, move_count + 1); }
 
 } // namespace game
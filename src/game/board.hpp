@@ -8,6 +8,8 @@
 #include "types.hpp"
 #include "fen.hpp"
 #include "array.hpp"
+#include "zobrist.hpp"
+#include "eval.hpp"
 
 namespace game {
 
@@ -17,7 +19,26 @@ struct BoardState {
     Piece captured_piece;
     Piece moved_piece;
     Move last_move;
+    uint16_t halfmove_clock; // Plies since the last capture or pawn move, the window repetitions are searched in
     BitBoard castle_rights_bit;
+    uint64_t key;         // Zobrist key, kept up to date by the piece mutators and apply_move
+    EvalState eval;       // Only kept up to date by moves made with EVAL_INCREMENTAL, recomputed by init and set_position
+    // Check info for the side to move, filled once per move by move and move_stateless. Redo keeps the stored one
+    BitBoard checkers;                                    // Enemy pieces giving check
+    gtr::array<BitBoard, COLOR_COUNT> pinned;             // Pieces of either color alone between that color's king and an enemy slider
+    gtr::array<BitBoard, PIECE_COUNT + 1> check_squares; // Squares a piece of each type would check the enemy king from
+    BoardState *previous; // State to restore on undo_stateless
+};
+
+// Piece placement at one ply of a board's timeline. The BoardStates stay in state_history, so restoring is a copy of the
+// arrays plus moving the read index, and the timeline before and after the snapshot remains undoable and redoable.
+struct BoardSnapshot {
+    gtr::array<Piece, SQUARE_COUNT> pieces;
+    gtr::array<BitBoard, PIECE_COUNT_PLUS_ANY> pieces_by_type;
+    gtr::array<BitBoard, COLOR_COUNT> pieces_by_color;
+    uint64_t history_index;
+    int32_t move_count;
+    Color side_to_move;
 };
 
 struct Board {
@@ -28,9 +49,17 @@ struct Board {
     BoardState *current_state{nullptr};
     int32_t move_count{0};
     Color side_to_move{PIECE_WHITE};
+    // Bumped by every change that outlives the call (move, undo, redo, set_position, restore, assignment), so views can cache
+    // whatever they derive from the position. move_stateless and undo_stateless always come in pairs and leave it alone.
+    uint64_t version{0};
 
     Board() { init(); }
 
+    // current_state is rebound to the copy's own timeline, so copies can be handed to other threads
+    Board(const Board &other) { *this = other; }
+
+    Board &operator=(const Board &other);
+
     Piece &operator[](const int32_t index) { return pieces[index]; }
 
     const Piece &operator[](const int32_t index) const { return pieces[index]; }
@@ -59,7 +88,7 @@ struct Board {
 
     void move(Move m, AlgebraicMove &out_alg);
 
-    void move_stateless(Move m, BoardState &state);
+    template <EvalPolicy E = EVAL_NONE> void move_stateless(Move m, BoardState &state);
 
     bool undo();
 
@@ -67,6 +96,11 @@ struct Board {
 
     bool redo();
 
+    BoardSnapshot snapshot() const;
+
+    // Only valid for snapshots taken on this board's current timeline
+    void restore(const BoardSnapshot &snapshot);
+
     static constexpr bool valid_rol_col(const int32_t row, const int32_t col) { return row >= RANK_1 && row <= RANK_7 && col >= FILE_A && col <= FILE_H; }
 
     bool pawn_is_being_promoted(const SimpleMove move) const {
@@ -80,8 +114,16 @@ struct Board {
 
     gtr::large_string board_to_string() const;
 
-    constexpr void move_piece(const SquareIndex origin, const SquareIndex destination) {
+    // The eval policy decides whether current_state->eval follows, the key policy whether current_state->key does.
+    // Undo passes KEY_NONE: the state it goes back to still holds its key, so current_state is not touched at all
+    template <EvalPolicy E = EVAL_NONE, KeyPolicy K = KEY_INCREMENTAL> constexpr void move_piece(const SquareIndex origin, const SquareIndex destination) {
         const Piece p = pieces[origin];
+        if constexpr (K == KEY_INCREMENTAL) {
+            current_state->key ^= ZOBRIST.pieces[p][origin] ^ ZOBRIST.pieces[p][destination];
+        }
+        if constexpr (E == EVAL_INCREMENTAL) {
+            eval_move(current_state->eval, p, origin, destination);
+        }
         pieces[destination] = pieces[origin];
         pieces[origin] = PIECE_NONE;
         bitboard_move_bit(pieces_by_type[PIECE_TYPE(p)], origin, destination);
@@ -90,13 +132,19 @@ struct Board {
         bitboard_move_bit(pieces_by_type[EMPTY], destination, origin);
     }
 
-    constexpr void move_piece(const int32_t row, const int32_t col, const int32_t to_row, const int32_t to_col) {
-        move_piece(static_cast<SquareIndex>(get_index(row, col)), static_cast<SquareIndex>(get_index(to_row, to_col)));
+    template <EvalPolicy E = EVAL_NONE, KeyPolicy K = KEY_INCREMENTAL> constexpr void move_piece(const int32_t row, const int32_t col, const int32_t to_row, const int32_t to_col) {
+        move_piece<E, K>(static_cast<SquareIndex>(get_index(row, col)), static_cast<SquareIndex>(get_index(to_row, to_col)));
     }
 
-    constexpr void remove_piece(const SquareIndex index) {
+    template <EvalPolicy E = EVAL_NONE, KeyPolicy K = KEY_INCREMENTAL> constexpr void remove_piece(const SquareIndex index) {
         const Piece piece = pieces[index];
         Assert(PIECE_TYPE(piece) != EMPTY, "Attempting to remove empty square");
+        if constexpr (K == KEY_INCREMENTAL) {
+            current_state->key ^= ZOBRIST.pieces[piece][index];
+        }
+        if constexpr (E == EVAL_INCREMENTAL) {
+            eval_remove(current_state->eval, piece, index);
+        }
         pieces[index] = PIECE_NONE;
         bitboard_clear(pieces_by_type[PIECE_TYPE(piece)], index);
         bitboard_clear(pieces_by_color[PIECE_COLOR(piece)], index);
@@ -104,10 +152,16 @@ struct Board {
         bitboard_set(pieces_by_type[EMPTY], index);
     }
 
-    constexpr void remove_piece(const int32_t row, const int32_t col) { remove_piece(static_cast<SquareIndex>(get_index(row, col))); }
+    template <EvalPolicy E = EVAL_NONE, KeyPolicy K = KEY_INCREMENTAL> constexpr void remove_piece(const int32_t row, const int32_t col) { remove_piece<E, K>(static_cast<SquareIndex>(get_index(row, col))); }
 
-    constexpr void put_piece(const Piece p, const SquareIndex s) {
+    template <EvalPolicy E = EVAL_NONE, KeyPolicy K = KEY_INCREMENTAL> constexpr void put_piece(const Piece p, const SquareIndex s) {
         Assert(PIECE_TYPE(p) != EMPTY, "Use remove piece");
+        if constexpr (K == KEY_INCREMENTAL) {
+            current_state->key ^= ZOBRIST.pieces[p][s];
+        }
+        if constexpr (E == EVAL_INCREMENTAL) {
+            eval_put(current_state->eval, p, s);
+        }
         pieces[s] = p;
         bitboard_set(pieces_by_type[PIECE_TYPE(p)], s);
         bitboard_set(pieces_by_color[PIECE_COLOR(p)], s);
@@ -123,4 +177,60 @@ struct Board {
 
     Fen get_fen() const;
 };
+
+// Pieces of both colors attacking the square, one lookup per piece kind taken from the square itself.
+// occ is normally pieces_by_type[ANY], pass a different occupancy to see through pieces (a king stepping along a ray, x-rays).
+// Works on anything with the Board bitboard members, Position included.
+template <SliderBackend B, typename Pos> BitBoard attackers_to(const Pos &board, const SquareIndex sq, const BitBoard occ) {
+    const BitBoard queens = board.pieces_by_type[QUEEN];
+    return (MAGIC_BOARD.pawn_attackers[PIECE_WHITE][sq] & board.get_piece_bitboard(PAWN, PIECE_WHITE)) |
+           (MAGIC_BOARD.pawn_attackers[PIECE_BLACK][sq] & board.get_piece_bitboard(PAWN, PIECE_BLACK)) | (MAGIC_BOARD.knight_attackers[sq] & board.pieces_by_type[KNIGHT]) |
+           (MAGIC_BOARD.king_attackers[sq] & board.pieces_by_type[KING]) | (MAGIC_BOARD.slider_attacks<BISHOP, B>(occ, sq) & (board.pieces_by_type[BISHOP] | queens)) |
+           (MAGIC_BOARD.slider_attacks<ROOK, B>(occ, sq) & (board.pieces_by_type[ROOK] | queens));
+}
+
+// Same query through the startup slider backend
+BitBoard attackers_to(const Board &board, SquareIndex sq, BitBoard occ);
+
+// Pieces of either color standing alone between the king and an enemy slider: the king's own ones are pinned,
+// the enemy ones give a discovered check when they leave the ray
+template <SliderBackend B, typename Pos> BitBoard slider_blockers(const Pos &board, const SquareIndex king, const Color king_color) {
+    const BitBoard occ = board.pieces_by_type[ANY];
+    const BitBoard queens = board.pieces_by_type[QUEEN];
+    const BitBoard snipers = ((MAGIC_BOARD.slider_attacks<ROOK, B>(0, king) & (board.pieces_by_type[ROOK] | queens)) |
+                              (MAGIC_BOARD.slider_attacks<BISHOP, B>(0, king) & (board.pieces_by_type[BISHOP] | queens))) &
+                             board.pieces_by_color[~king_color];
+    BitBoard blockers = 0;
+    for (const auto sniper : BitBoardIterator(snipers)) {
+        const BitBoard between = MAGIC_BOARD.between_squares[king][sniper] & occ;
+        if (between && !(between & (between - 1))) {
+            blockers |= between;
+        }
+    }
+    return blockers;
+}
+
+// Fills the check info of the state from the board's pieces, for the given side to move
+void board_update_check_info(const Board &board, BoardState &state, Color side_to_move);
+
+// The make step shared by move, move_stateless and redo: pieces, castle rights, en passant and key, but not the side to move
+// and not the check info, which only the callers that generate moves afterwards fill with board_update_check_info.
+// Public so game_bench can time it on its own, everything else goes through the Board members.
+template <EvalPolicy E = EVAL_NONE> void board_apply_move(Board &board, Move move, BoardState &state);
+
+// Castle rights that survive a move leaving or landing on each square, king and rook origins clear the matching rights
+inline constexpr auto CASTLE_RIGHTS_MASK = [] {
+    gtr::array<std::byte, SQUARE_COUNT> mask{};
+    for (auto &m : mask) { m = CASTLE_RIGHTS_ALL; }
+    mask[A1] = ~CASTLE_WHITE_QUEENSIDE;
+    mask[H1] = ~CASTLE_WHITE_KINGSIDE;
+    mask[E1] = ~CASTLE_WHITE_ALL;
+    mask[A8] = ~CASTLE_BLACK_QUEENSIDE;
+    mask[H8] = ~CASTLE_BLACK_KINGSIDE;
+    mask[E8] = ~CASTLE_BLACK_ALL;
+    return mask;
+}();
+
+// Clears the castle rights bound to the origin and destination squares
+void board_update_rights(BoardState &state, SquareIndex origin, SquareIndex destination);
 } // namespace game
@@ -0,0 +1,20 @@
+#include "eval.hpp"
+#include "board.hpp"
+#include "position.hpp"
+
+namespace game {
+template <typename Pos> static EvalState eval_compute_from_bitboards(const Pos &pos) {
+    EvalState eval{};
+    for (int32_t c = PIECE_WHITE; c <= PIECE_BLACK; ++c) {
+        for (int32_t t = PAWN; t <= KING; ++t) {
+            const Piece piece = chess_piece_make(static_cast<PieceType>(t), static_cast<Color>(c));
+            for (const auto sq : BitBoardIterator(pos.get_piece_bitboard(static_cast<PieceType>(t), static_cast<Color>(c)))) { eval_put(eval, piece, sq); }
+        }
+    }
+    return eval;
+}
+
+EvalState eval_compute(const Board &board) { return eval_compute_from_bitboards(board); }
+
+EvalState eval_compute(const Position &pos) { return eval_compute_from_bitboards(pos); }
+} // namespace game
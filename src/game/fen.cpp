@@ -133,8 +133,8 @@ SquareIndex Fen::en_passant_square() const {
 
 std::byte Fen::castle_rights() const {
     std::byte rights{};
-    for (char right = at(fields_index[1]); right != ' '; ++right) {
-        switch (right) {
+    for (auto i = fields_index[1]; at(i) != ' '; ++i) {
+        switch (at(i)) {
         case 'K': rights |= CASTLE_WHITE_KINGSIDE; break;
         case 'Q': rights |= CASTLE_WHITE_QUEENSIDE; break;
         case 'k': rights |= CASTLE_BLACK_KINGSIDE; break;
@@ -1,38 +1,56 @@
 #include "game.hpp"
+#include <algorithm>
 #include "analyzer.hpp"
+#include "movegen.hpp"
+#include "repetition.hpp"
 namespace game {
+// Keeps one snapshot every CHECKPOINT_INTERVAL plies. A move played after an undo rewrites the timeline from the
+// current ply on, so the checkpoints past it are dropped before the new one is taken.
+static void game_record_checkpoint(Game *g) {
+    const uint64_t ply = g->current_ply();
+    g->checkpoints.resize((ply + Game::CHECKPOINT_INTERVAL - 1) / Game::CHECKPOINT_INTERVAL);
+    if (ply % Game::CHECKPOINT_INTERVAL == 0) {
+        g->checkpoints.push_back(g->board.snapshot());
+    }
+}
+
 Game::Game() {
     board.init();
     board.populate();
     push_move(AlgebraicMove{""});
+    game_record_checkpoint(this);
 }
 
 static Player &game_get_player(Game *g, Color c) { return c == PIECE_WHITE ? g->white_player : g->black_player; }
 
-static void game_update_status(Game *g) {
+Game::GameStatus analyze_terminal_state(const Board &board) {
     using enum Game::GameStatus;
-    if (analyzer_is_color_in_checkmate(&g->board, PIECE_BLACK)) {
-        g->status = BLACK_CHECKMATE;
-    } else if (analyzer_is_color_in_checkmate(&g->board, PIECE_WHITE)) {
-        g->status = WHITE_CHECKMATE;
-    } else if (g->board.side_to_move == PIECE_WHITE && analyzer_get_is_stalemate(&g->board, PIECE_WHITE)) {
-        g->status = WHITE_STALEMATE;
-    } else if (g->board.side_to_move == PIECE_BLACK && analyzer_get_is_stalemate(&g->board, PIECE_BLACK)) {
-        g->status = BLACK_STALEMATE;
-    } else if (analyzer_is_insufficient_material(&g->board)) {
-        g->status = INSUFFICIENT_MATERIAL;
-    } else if (g->board.side_to_move == PIECE_WHITE) {
-        g->status = WHITE_TURN;
-    } else if (g->board.side_to_move  == PIECE_BLACK) {
-        g->status = BLACK_TURN;
-    } else {
-        g->status = INVALID;
+    const Color us = board.side_to_move;
+    // Only the side to move can be mated or stalemated, and the check test is only needed once it has no move
+    if (!has_any_legal_move(board)) {
+        const auto king = static_cast<SquareIndex>(lsb(board.get_piece_bitboard(KING, us)));
+        if (attackers_to(board, king, board.pieces_by_type[ANY]) & board.pieces_by_color[~us]) {
+            return us == PIECE_WHITE ? WHITE_CHECKMATE : BLACK_CHECKMATE;
+        }
+        return us == PIECE_WHITE ? WHITE_STALEMATE : BLACK_STALEMATE;
+    }
+    if (board.current_state->halfmove_clock >= FIFTY_MOVE_RULE_PLIES) {
+        return FIFTY_MOVE_RULE;
+    }
+    if (board_repetition_count(board) >= 2) {
+        return THREEFOLD_REPETITION;
+    }
+    if (analyzer_is_insufficient_material(&board)) {
+        return INSUFFICIENT_MATERIAL;
     }
+    return us == PIECE_WHITE ? WHITE_TURN : BLACK_TURN;
 }
 
+static void game_update_status(Game *g) { g->status = analyze_terminal_state(g->board); }
+
 bool game_is_playable(const Game *g) {
     using enum Game::GameStatus;
-    return g->status != WHITE_CHECKMATE && g->status != BLACK_CHECKMATE && g->status != WHITE_STALEMATE && g->status != BLACK_STALEMATE && g->status != INSUFFICIENT_MATERIAL;
+    return g->status == WHITE_TURN || g->status == BLACK_TURN;
 }
 
 bool Game::move(const Move &move) {
@@ -43,6 +61,7 @@ bool Game::move(const Move &move) {
     if (board.get_color(move.from_row(), move.from_col()) == board.side_to_move && moves.get(move.to_row(), move.to_col())) {
         AlgebraicMove algebraic_move;
         board.move(move, algebraic_move);
+        game_record_checkpoint(this);
         game_update_status(this);
         push_move(algebraic_move);
         return true;
@@ -61,6 +80,8 @@ bool Game::redo() {
 
 void Game::set_position(const Fen &fen) {
     board.set_position(fen);
+    checkpoints.clear();
+    game_record_checkpoint(this);
     update();
     move_list.clear();
     move_list.push(AlgebraicMove{""});
@@ -80,15 +101,19 @@ void Game::update() {
     using enum GameWinner;
     if (game_is_playable(this)) {
         winner = PLAYING;
+        // An engine still thinking hands back an empty move, it is asked again on the next tick
         if (player_is_ai(game_get_player(this, board.side_to_move))) {
-            move(player_get_move(game_get_player(this, board.side_to_move), board));
+            if (const Move m = player_get_move(game_get_player(this, board.side_to_move), board); m != Move{}) {
+                move(m);
+            }
         }
     } else {
         if (status == WHITE_CHECKMATE) {
             winner = BLACK;
         } else if (status == BLACK_CHECKMATE) {
             winner = WHITE;
-        } else if (status == WHITE_STALEMATE || status == BLACK_STALEMATE || status == INSUFFICIENT_MATERIAL) {
+        } else if (status == WHITE_STALEMATE || status == BLACK_STALEMATE || status == INSUFFICIENT_MATERIAL || status == THREEFOLD_REPETITION ||
+                   status == FIFTY_MOVE_RULE) {
             winner = DRAW;
         }
     }
@@ -108,12 +133,26 @@ bool Game::random_move() {
     return move(player_get_move(player, board));
 }
 
-void Game::return_last_move() {
-    while (redo()) {/** Redo until it cannot */}
-}
+void Game::return_last_move() { seek(last_ply()); }
 
-void Game::return_first_move() {
-    while (undo()) {/** Undo until it cannot */}
+void Game::return_first_move() { seek(0); }
+
+bool Game::seek(const uint64_t ply) {
+    if (ply > last_ply()) {
+        return false;
+    }
+    // Walk from the current ply when that is no longer than the replay from the checkpoint below the target
+    const uint64_t current = current_ply();
+    const uint64_t checkpoint = std::min<uint64_t>(ply / CHECKPOINT_INTERVAL, checkpoints.size() - 1);
+    const uint64_t distance = current > ply ? current - ply : ply - current;
+    if (distance > ply - checkpoint * CHECKPOINT_INTERVAL) {
+        board.restore(checkpoints[checkpoint]);
+    }
+    while (current_ply() > ply) { board.undo(); }
+    while (current_ply() < ply) { board.redo(); }
+    move_list.read_index = ply;
+    game_update_status(this);
+    return true;
 }
 
 bool Game::board_in_check() { return analyzer_is_color_in_check(&board, PIECE_WHITE) || analyzer_is_color_in_check(&board, PIECE_BLACK); }
@@ -123,15 +162,19 @@ void Game::tick() {
     using enum GameWinner;
     if (game_is_playable(this)) {
         winner = PLAYING;
+        // An engine still thinking hands back an empty move, it is asked again on the next tick
         if (player_is_ai(game_get_player(this, board.side_to_move))) {
-            move(player_get_move(game_get_player(this, board.side_to_move), board));
+            if (const Move m = player_get_move(game_get_player(this, board.side_to_move), board); m != Move{}) {
+                move(m);
+            }
         }
     } else {
         if (status == WHITE_CHECKMATE) {
             winner = BLACK;
         } else if (status == BLACK_CHECKMATE) {
             winner = WHITE;
-        } else if (status == WHITE_STALEMATE || status == BLACK_STALEMATE || status == INSUFFICIENT_MATERIAL) {
+        } else if (status == WHITE_STALEMATE || status == BLACK_STALEMATE || status == INSUFFICIENT_MATERIAL || status == THREEFOLD_REPETITION ||
+                   status == FIFTY_MOVE_RULE) {
             winner = DRAW;
         }
     }
@@ -145,6 +188,8 @@ void Game::reset() {
     winner = GameWinner::PLAYING;
     move_list.clear();
     push_move(AlgebraicMove{""});
+    checkpoints.clear();
+    game_record_checkpoint(this);
 }
 
 const char *Game::get_status_string() const {
@@ -157,6 +202,8 @@ const char *Game::get_status_string() const {
     case WHITE_STALEMATE      : return "White is in stalemate";
     case BLACK_STALEMATE      : return "Black is in stalemate";
     case INSUFFICIENT_MATERIAL: return "Insufficient material";
+    case THREEFOLD_REPETITION : return "Threefold repetition";
+    case FIFTY_MOVE_RULE      : return "Fifty-move rule";
     default                   : return "Unknown game status";
     }
 }
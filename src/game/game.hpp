@@ -6,8 +6,11 @@
 
 namespace game {
 struct Game {
+    static constexpr uint64_t CHECKPOINT_INTERVAL = 16; // Plies between two board snapshots, a seek replays at most this many moves
+
     // Updated every move
-    enum class GameStatus { WHITE_TURN, BLACK_TURN, WHITE_CHECKMATE, BLACK_CHECKMATE, WHITE_STALEMATE, BLACK_STALEMATE, INSUFFICIENT_MATERIAL, INVALID };
+    enum class GameStatus { WHITE_TURN, BLACK_TURN, WHITE_CHECKMATE, BLACK_CHECKMATE, WHITE_STALEMATE, BLACK_STALEMATE, INSUFFICIENT_MATERIAL, THREEFOLD_REPETITION, FIFTY_MOVE_RULE,
+                            INVALID };
 
     // Updated every game tick
     enum class GameWinner { WHITE, BLACK, DRAW, PLAYING };
@@ -18,6 +21,7 @@ struct Game {
     GameStatus status{GameStatus::WHITE_TURN};
     GameWinner winner{GameWinner::PLAYING};
     history<AlgebraicMove> move_list{};
+    gtr::vector<BoardSnapshot> checkpoints{}; // checkpoints[i] is the board at ply i * CHECKPOINT_INTERVAL of the current timeline
 
     Game();
 
@@ -42,6 +46,10 @@ struct Game {
     bool redo();
     void return_last_move();
     void return_first_move();
+    // Jumps to any ply of the timeline, undone moves included, the status is only recomputed at the destination
+    bool seek(uint64_t ply);
+    uint64_t current_ply() const { return board.state_history.read_index; }
+    uint64_t last_ply() const { return board.state_history.data.size() - 1; }
     bool board_in_check();
     void tick();
     void reset();
@@ -56,4 +64,8 @@ struct Game {
     bool set_position(const char *fen_string);
 
 };
+
+// Status of the side to move in one pass: a single early-exit legal move search, the check test only when it finds
+// nothing, then the fifty-move rule, repetitions and insufficient material. A mate on the hundredth ply still counts.
+Game::GameStatus analyze_terminal_state(const Board &board);
 } // namespace game
@@ -0,0 +1,164 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+#include "../bitboard.hpp"
+#include "../repetition.hpp"
+#include "../zobrist.hpp"
+
+/*
+ Build time generator for MAGIC_BOARD. Runs detail::init_magic_boards once and writes the result as a constant
+ initializer, so the tables are placed in .rodata and the game does no work at startup. The repetition CUCKOO table is
+ written the same way, as a constant expression it needed more steps than compilers allow by default.
+ usage: magic_gen <output.cpp>
+*/
+using namespace game;
+
+static void emit(FILE *f, const uint64_t v) { std::fprintf(f, "0x%llxULL", static_cast<unsigned long long>(v)); }
+
+static void emit(FILE *f, const uint32_t v) { std::fprintf(f, "%uU", v); }
+
+static void emit(FILE *f, const uint16_t v) { std::fprintf(f, "%u", v); }
+
+static void emit(FILE *f, const int32_t v) { std::fprintf(f, "%d", v); }
+
+static void emit(FILE *f, const Move v) { std::fprintf(f, "Move{%u}", v.move); }
+
+static void emit(FILE *f, const SquareIndex v) { std::fprintf(f, "SquareIndex{%u}", std::to_underlying(v)); }
+
+template <class T, size_t N> static void emit(FILE *f, const gtr::array<T, N> &a) {
+    std::fputs("{{", f);
+    for (size_t i = 0; i < N; ++i) {
+        if (i != 0) {
+            std::fputc(',', f);
+        }
+        if (i % 16 == 0 && N > 16) {
+            std::fputc('\n', f);
+        }
+        emit(f, a[i]);
+    }
+    std::fputs("}}", f);
+}
+
+template <class T> static void emit_field(FILE *f, const char *name, const T &value) {
+    std::fprintf(f, "    .%s = ", name);
+    emit(f, value);
+    std::fputs(",\n", f);
+}
+
+// Whether the piece goes from s1 to s2 in one move on an empty board
+static bool cuckoo_reaches(const MagicBoards &mb, const PieceType type, const int32_t s1, const int32_t s2) {
+    const bool aligned = mb.line_squares[s1][s2] != 0;
+    const bool straight = s1 % 8 == s2 % 8 || s1 / 8 == s2 / 8;
+    switch (type) {
+    case KNIGHT: return mb.knight_attacks[s1] >> s2 & 1;
+    case BISHOP: return aligned && !straight;
+    case ROOK  : return aligned && straight;
+    case QUEEN : return aligned;
+    case KING  : return mb.king_attacks[s1] >> s2 & 1;
+    default    : return false;
+    }
+}
+
+static CuckooTable init_cuckoo_table(const MagicBoards &mb, int32_t &count) {
+    CuckooTable table{};
+    count = 0;
+    for (int32_t c = PIECE_WHITE; c <= PIECE_BLACK; ++c) {
+        for (int32_t t = KNIGHT; t <= KING; ++t) {
+            const Piece piece = chess_piece_make(static_cast<PieceType>(t), static_cast<Color>(c));
+            for (int32_t s1 = 0; s1 < SQUARE_COUNT; ++s1) {
+                for (int32_t s2 = s1 + 1; s2 < SQUARE_COUNT; ++s2) {
+                    if (!cuckoo_reaches(mb, static_cast<PieceType>(t), s1, s2)) {
+                        continue;
+                    }
+                    Move move = move_make(static_cast<uint8_t>(s1), static_cast<uint8_t>(s2));
+                    uint64_t key = ZOBRIST.pieces[piece][s1] ^ ZOBRIST.pieces[piece][s2] ^ ZOBRIST.side;
+                    // Insert, kicking whatever sits there to its other slot until an empty one is found
+                    uint32_t slot = cuckoo_h1(key);
+                    while (true) {
+                        std::swap(table.keys[slot], key);
+                        std::swap(table.moves[slot], move);
+                        if (move == Move{}) {
+                            break;
+                        }
+                        slot = slot == cuckoo_h1(key) ? cuckoo_h2(key) : cuckoo_h1(key);
+                    }
+                    ++count;
+                }
+            }
+        }
+    }
+    return table;
+}
+
+int main(const int argc, char **argv) {
+    if (argc < 2) {
+        std::printf("usage: magic_gen <output.cpp>\n");
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    static const MagicBoards mb = detail::init_magic_boards();
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    int32_t cuckoo_count = 0;
+    static const CuckooTable cuckoo = init_cuckoo_table(mb, cuckoo_count);
+    if (cuckoo_count != 3668) {
+        std::printf("magic_gen: %d cuckoo moves, every reversible knight, bishop, rook, queen and king move should be in the table\n", cuckoo_count);
+        return 1;
+    }
+
+    FILE *f = std::fopen(argv[1], "w");
+    if (f == nullptr) {
+        std::printf("magic_gen: cannot open '%s'\n", argv[1]);
+        return 1;
+    }
+    std::fputs("// Generated by magic_gen from detail::init_magic_boards, do not edit\n"
+               "#include \"bitboard.hpp\"\n"
+               "#include \"repetition.hpp\"\n\n"
+               "namespace game {\n"
+               "alignas(64) constinit const MagicBoards MAGIC_BOARD = {\n",
+               f);
+    emit_field(f, "en_passant_conversion_table", mb.en_passant_conversion_table);
+    emit_field(f, "pawn_attacks", mb.pawn_attacks);
+    emit_field(f, "pawn_moves", mb.pawn_moves);
+    emit_field(f, "knight_attacks", mb.knight_attacks);
+    emit_field(f, "king_attacks", mb.king_attacks);
+    emit_field(f, "castle_king_empty", mb.castle_king_empty);
+    emit_field(f, "castle_king_squares", mb.castle_king_squares);
+    emit_field(f, "castle_queen_empty", mb.castle_queen_empty);
+    emit_field(f, "castle_queen_squares", mb.castle_queen_squares);
+    emit_field(f, "king_row", mb.king_row);
+    emit_field(f, "castle_king_dest", mb.castle_king_dest);
+    emit_field(f, "castle_queen_dest", mb.castle_queen_dest);
+    emit_field(f, "pawn_attackers", mb.pawn_attackers);
+    emit_field(f, "knight_attackers", mb.knight_attackers);
+    emit_field(f, "king_attackers", mb.king_attackers);
+    emit_field(f, "between_squares", mb.between_squares);
+    emit_field(f, "line_squares", mb.line_squares);
+    emit_field(f, "bishop_mask", mb.bishop_mask);
+    emit_field(f, "bishop_magic", mb.bishop_magic);
+    emit_field(f, "bishop_shift", mb.bishop_shift);
+    emit_field(f, "bishop_offset", mb.bishop_offset);
+    emit_field(f, "bishop_unique_indexes", mb.bishop_unique_indexes);
+    emit_field(f, "bishop_unique_table", mb.bishop_unique_table);
+    emit_field(f, "rook_mask", mb.rook_mask);
+    emit_field(f, "rook_magic", mb.rook_magic);
+    emit_field(f, "rook_shift", mb.rook_shift);
+    emit_field(f, "rook_offset", mb.rook_offset);
+    emit_field(f, "rook_unique_indexes", mb.rook_unique_indexes);
+    emit_field(f, "rook_unique_table", mb.rook_unique_table);
+    emit_field(f, "bishop_pext_table", mb.bishop_pext_table);
+    emit_field(f, "rook_pext_table", mb.rook_pext_table);
+    emit_field(f, "bishop_direct_table", mb.bishop_direct_table);
+    emit_field(f, "rook_direct_table", mb.rook_direct_table);
+    std::fputs("};\n\nconstinit const CuckooTable CUCKOO = {\n", f);
+    emit_field(f, "keys", cuckoo.keys);
+    emit_field(f, "moves", cuckoo.moves);
+    std::fputs("};\n} // namespace game\n", f);
+    std::fclose(f);
+
+    // This is the time every process used to spend in static initialization before the tables were generated
+    std::printf("magic_gen: init_magic_boards took %.2f ms, tables written to %s\n", elapsed, argv[1]);
+    return 0;
+}
@@ -76,6 +76,17 @@ AlgebraicMove move_to_algebraic(Board &board, const Move move) {
     return result;
 }
 
+AlgebraicMove move_to_uci(const Move move) {
+    AlgebraicMove result;
+    result.append(CellNamesC[move.get_origin()]);
+    result.append(CellNamesC[move.get_destination()]);
+    if (move.is_promotion()) {
+        static constexpr char promo_map[] = {'q', 'r', 'b', 'n'};
+        result.push_back(promo_map[std::to_underlying(move.get_promotion_piece())]);
+    }
+    return result;
+}
+
 static MoveParserConversionError algebraic_pawn_to_move(const Color turn, const Board &board, const AlgebraicMove &move, Move &result) {
     using enum MoveParserConversionError;
     const bool capture = algebraic_is_capture(move);
@@ -107,10 +107,19 @@ struct Move {
     }
 };
 
+constexpr Move move_make(const uint8_t origin, const uint8_t destination, const Move::MoveSpecialType special = Move::MOVE_NONE,
+                         const PromotionPieceType promotion = PROMOTION_QUEEN) noexcept {
+    return Move{static_cast<Move::storage_type>((origin & Move::ORIGIN_MASK) << Move::ORIGIN_SHIFT | (destination & Move::DEST_MASK) << Move::DEST_SHIFT |
+                                                (std::to_underlying(promotion) & Move::PROMO_MASK) << Move::PROMO_SHIFT |
+                                                (std::to_underlying(special) & Move::FLAGS_MASK) << Move::FLAGS_SHIFT)};
+}
+
 using AlgebraicMove = gtr::char_string<32>;
 constexpr auto MIN_ALGEBRAIC_MOVE_LENGTH = 2; // Minimum length for a move (e.g., "e4")
 struct Board;
 AlgebraicMove move_to_algebraic(Board &board, Move move);
+AlgebraicMove move_to_uci(Move move); // Coordinate notation, e.g. "e2e4" or "e7e8q"
+
 enum class MoveParserConversionError {
     NONE,
     DISAMBIGUATION_NEEDED,
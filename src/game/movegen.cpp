@@ -0,0 +1,465 @@
+#include "movegen.hpp"
+#include "bitboard.hpp"
+#include "board.hpp"
+#include "move.hpp"
+#include "position.hpp"
+
+namespace game {
+// Indexed by the side to move. The generators take the side as a template argument, so every lookup below folds into a constant
+static constexpr gtr::array PROMOTION_RANKS = {Rank8, Rank1};
+static constexpr gtr::array DOUBLE_PUSH_RANKS = {Rank3, Rank6}; // Rank reached after the first push
+static constexpr gtr::array PAWN_PUSH = {static_cast<int32_t>(BLACK_DIRECTION), static_cast<int32_t>(WHITE_DIRECTION)};
+static constexpr gtr::array CASTLE_KING_SIDE_RIGHTS = {CASTLE_WHITE_KINGSIDE, CASTLE_BLACK_KINGSIDE};
+static constexpr gtr::array CASTLE_QUEEN_SIDE_RIGHTS = {CASTLE_WHITE_QUEENSIDE, CASTLE_BLACK_QUEENSIDE};
+static constexpr gtr::array CASTLE_KING_SIDE_EMPTY = {bitboard_from_squares<F1, G1>(), bitboard_from_squares<F8, G8>()};
+static constexpr gtr::array CASTLE_QUEEN_SIDE_EMPTY = {bitboard_from_squares<D1, C1, B1>(), bitboard_from_squares<D8, C8, B8>()};
+static constexpr gtr::array CASTLE_KING_SIDE_PATH = {bitboard_from_squares<F1, G1>(), bitboard_from_squares<F8, G8>()}; // Squares the king crosses
+static constexpr gtr::array CASTLE_QUEEN_SIDE_PATH = {bitboard_from_squares<D1, C1>(), bitboard_from_squares<D8, C8>()};
+static constexpr gtr::array CASTLE_KING_ORIGIN = {E1, E8};
+static constexpr gtr::array CASTLE_KING_SIDE_DEST = {G1, G8};
+static constexpr gtr::array CASTLE_QUEEN_SIDE_DEST = {C1, C8};
+static constexpr gtr::array CASTLE_KING_SIDE_ROOK = {H1, H8};
+static constexpr gtr::array CASTLE_QUEEN_SIDE_ROOK = {A1, A8};
+
+// The generators run on Board and on Position, these cover the fields the two store differently
+static int8_t movegen_en_passant_index(const Board &board) { return board.current_state->en_passant_index; }
+static int8_t movegen_en_passant_index(const Position &pos) { return pos.en_passant_index; }
+static std::byte movegen_castle_rights(const Board &board) { return board.current_state->castle_rights; }
+static std::byte movegen_castle_rights(const Position &pos) { return pos.castle_rights; }
+static Piece movegen_piece_on(const Board &board, const SquareIndex sq) { return board.pieces[sq]; }
+static Piece movegen_piece_on(const Position &pos, const SquareIndex sq) { return position_piece_on(pos, sq); }
+
+// Every piece of color 'by' attacking the square, given the occupancy
+template <SliderBackend B, typename Pos> static BitBoard movegen_attackers_to(const Pos &board, const SquareIndex sq, const BitBoard occ, const Color by) {
+    return attackers_to<B>(board, sq, occ) & board.pieces_by_color[by];
+}
+
+// Board caches the check info of the side to move in its state, Position works it out on every call
+template <SliderBackend B> static BitBoard movegen_checkers(const Board &board, SquareIndex, Color) { return board.current_state->checkers; }
+
+template <SliderBackend B> static BitBoard movegen_checkers(const Position &pos, const SquareIndex king, const Color us) {
+    return movegen_attackers_to<B>(pos, king, pos.pieces_by_type[ANY], ~us);
+}
+
+// Friendly pieces standing alone between the king and an enemy slider
+template <SliderBackend B> static BitBoard movegen_pinned(const Board &board, SquareIndex, const Color us) {
+    return board.current_state->pinned[us] & board.pieces_by_color[us];
+}
+
+template <SliderBackend B> static BitBoard movegen_pinned(const Position &pos, const SquareIndex king, const Color us) {
+    return slider_blockers<B>(pos, king, us) & pos.pieces_by_color[us];
+}
+
+// Squares a knight, bishop, rook or queen on the square attacks
+template <SliderBackend B, PieceType T> static BitBoard movegen_attacks(const SquareIndex from, const BitBoard occ) {
+    if constexpr (T == KNIGHT) {
+        return MAGIC_BOARD.knight_attacks[from];
+    } else if constexpr (T == QUEEN) {
+        return MAGIC_BOARD.slider_attacks<BISHOP, B>(occ, from) | MAGIC_BOARD.slider_attacks<ROOK, B>(occ, from);
+    } else {
+        return MAGIC_BOARD.slider_attacks<T, B>(occ, from);
+    }
+}
+
+// Squares a single pawn of the side can reach. Only used for pinned pawns and move validation, the generators shift the whole set
+template <Color Us, typename Pos> static BitBoard movegen_pawn_reach(const Pos &board, const SquareIndex from) {
+    const BitBoard empty = board.pieces_by_type[EMPTY];
+    const BitBoard single = bitboard_from_squares(from + PAWN_PUSH[Us]) & empty;
+    const BitBoard double_push = single & DOUBLE_PUSH_RANKS[Us] ? bitboard_from_squares(from + 2 * PAWN_PUSH[Us]) & empty : 0;
+    return single | double_push | (MAGIC_BOARD.pawn_attacks[Us][from] & board.pieces_by_color[~Us]);
+}
+
+// Materializes every move into a MoveList
+struct MoveListSink {
+    MoveList &list;
+
+    void add(const Move m) { list.push(m); }
+
+    void add(const SquareIndex from, BitBoard targets) {
+        while (targets) {
+            list.push(move_make(from, static_cast<uint8_t>(lsb(targets))));
+            targets &= targets - 1;
+        }
+    }
+
+    void add_promotions(const SquareIndex from, const SquareIndex to) {
+        list.push(move_make(from, to, Move::MOVE_PROMOTION, PROMOTION_QUEEN));
+        list.push(move_make(from, to, Move::MOVE_PROMOTION, PROMOTION_ROOK));
+        list.push(move_make(from, to, Move::MOVE_PROMOTION, PROMOTION_BISHOP));
+        list.push(move_make(from, to, Move::MOVE_PROMOTION, PROMOTION_KNIGHT));
+    }
+
+    template <Color Us> void add_pawn(const SquareIndex from, const BitBoard targets) {
+        const BitBoard promotions = targets & PROMOTION_RANKS[Us];
+        add(from, targets & ~promotions);
+        for (const auto to : BitBoardIterator(promotions)) { add_promotions(from, to); }
+    }
+
+    // Targets of pawns that all moved by the same shift, each origin is its target minus the shift
+    template <Color Us, int32_t D> void add_pawns(const BitBoard targets) {
+        const BitBoard promotions = targets & PROMOTION_RANKS[Us];
+        for (const auto to : BitBoardIterator(targets & ~promotions)) { list.push(move_make(to - D, to)); }
+        for (const auto to : BitBoardIterator(promotions)) { add_promotions(static_cast<SquareIndex>(to - D), to); }
+    }
+};
+
+// Only records whether one specific move was produced, used to validate castles and en passant
+struct MoveMatchSink {
+    Move wanted;
+    bool found{false};
+
+    void add(const Move m) { found = found || m == wanted; }
+};
+
+// Only counts the moves, destination sets are popcounted
+struct MoveCountSink {
+    int32_t count{0};
+
+    void add(Move) { ++count; }
+
+    void add(SquareIndex, const BitBoard targets) { count += popcnt(targets); }
+
+    template <Color Us> void add_pawn(SquareIndex, const BitBoard targets) { count += popcnt(targets) + 3 * popcnt(targets & PROMOTION_RANKS[Us]); }
+
+    template <Color Us, int32_t D> void add_pawns(const BitBoard targets) { count += popcnt(targets) + 3 * popcnt(targets & PROMOTION_RANKS[Us]); }
+};
+
+template <SliderBackend B, Color Us, typename Pos, typename Sink> static void movegen_en_passant(const Pos &board, const SquareIndex king, Sink &sink) {
+    const int8_t ep_index = movegen_en_passant_index(board);
+    if (ep_index == EN_PASSANT_INVALID_INDEX) {
+        return;
+    }
+    const auto ep = static_cast<SquareIndex>(ep_index);
+    const auto captured = static_cast<SquareIndex>(ep_index - PAWN_PUSH[Us]);
+    const BitBoard capturers = MAGIC_BOARD.pawn_attackers[Us][ep] & board.template get_piece_bitboard<PAWN, Us>();
+    for (const auto from : BitBoardIterator(capturers)) {
+        // Two pawns leave the board in a single move, so the usual pin and evasion masks do not apply; check the resulting occupancy directly
+        const BitBoard occ = (board.pieces_by_type[ANY] ^ bitboard_from_squares(from, captured)) | bitboard_from_squares(ep);
+        if (!(movegen_attackers_to<B>(board, king, occ, ~Us) & ~bitboard_from_squares(captured))) {
+            sink.add(move_make(from, ep, Move::MOVE_EN_PASSANT));
+        }
+    }
+}
+
+template <SliderBackend B, Color Us, typename Pos, typename Sink> static void movegen_castles(const Pos &board, Sink &sink) {
+    const std::byte rights = movegen_castle_rights(board);
+    const BitBoard occ = board.pieces_by_type[ANY];
+    const BitBoard rooks = board.template get_piece_bitboard<ROOK, Us>();
+
+    if ((rights & CASTLE_KING_SIDE_RIGHTS[Us]) != CASTLE_NONE && !(occ & CASTLE_KING_SIDE_EMPTY[Us]) && bitboard_get(rooks, CASTLE_KING_SIDE_ROOK[Us])) {
+        bool safe = true;
+        for (const auto sq : BitBoardIterator(CASTLE_KING_SIDE_PATH[Us])) { safe = safe && !movegen_attackers_to<B>(board, sq, occ, ~Us); }
+        if (safe) {
+            sink.add(move_make(CASTLE_KING_ORIGIN[Us], CASTLE_KING_SIDE_DEST[Us], Move::MOVE_CASTLE));
+        }
+    }
+    if ((rights & CASTLE_QUEEN_SIDE_RIGHTS[Us]) != CASTLE_NONE && !(occ & CASTLE_QUEEN_SIDE_EMPTY[Us]) && bitboard_get(rooks, CASTLE_QUEEN_SIDE_ROOK[Us])) {
+        // Only the squares the king crosses must be safe, the rook may pass over an attacked b-file square
+        bool safe = true;
+        for (const auto sq : BitBoardIterator(CASTLE_QUEEN_SIDE_PATH[Us])) { safe = safe && !movegen_attackers_to<B>(board, sq, occ, ~Us); }
+        if (safe) {
+            sink.add(move_make(CASTLE_KING_ORIGIN[Us], CASTLE_QUEEN_SIDE_DEST[Us], Move::MOVE_CASTLE));
+        }
+    }
+}
+
+// Knights, and bishops or rooks with the queens riding along. A pinned knight never moves, a pinned slider stays on the ray through its king
+template <SliderBackend B, PieceType T, typename Sink>
+static void movegen_piece_moves(const BitBoard pieces, const BitBoard occ, const BitBoard targets, const BitBoard pinned, const SquareIndex king, Sink &sink) {
+    if constexpr (T == KNIGHT) {
+        for (const auto from : BitBoardIterator(pieces & ~pinned)) { sink.add(from, movegen_attacks<B, KNIGHT>(from, occ) & targets); }
+    } else {
+        for (const auto from : BitBoardIterator(pieces)) {
+            const BitBoard pin_ray = bitboard_get(pinned, from) ? MAGIC_BOARD.line_squares[king][from] : BITBOARD_FULL;
+            sink.add(from, movegen_attacks<B, T>(from, occ) & targets & pin_ray);
+        }
+    }
+}
+
+template <SliderBackend B, GenType G, Color Us, typename Pos, typename Sink> static void movegen_generate(const Pos &board, Sink &sink) {
+    constexpr Color them = ~Us;
+    constexpr int32_t up = PAWN_PUSH[Us];
+    constexpr BitBoard promotion_rank = PROMOTION_RANKS[Us];
+    const BitBoard occ = board.pieces_by_type[ANY];
+    const BitBoard friendly = board.pieces_by_color[Us];
+    const BitBoard enemy = board.pieces_by_color[them];
+    const BitBoard empty = board.pieces_by_type[EMPTY];
+    const BitBoard stage_mask = G == GEN_CAPTURES ? enemy : G == GEN_QUIETS ? empty : BITBOARD_FULL;
+    const BitBoard king_bb = board.template get_piece_bitboard<KING, Us>();
+    const auto king = static_cast<SquareIndex>(lsb(king_bb));
+
+    const BitBoard checkers = movegen_checkers<B>(board, king, Us);
+    const BitBoard pinned = movegen_pinned<B>(board, king, Us);
+
+    // The king can never hide behind itself from a slider, so it is removed from the occupancy when testing its destinations
+    for (const auto to : BitBoardIterator(MAGIC_BOARD.king_attacks[king] & ~friendly & stage_mask)) {
+        if (!movegen_attackers_to<B>(board, to, occ ^ king_bb, them)) {
+            sink.add(move_make(king, to));
+        }
+    }
+
+    if (checkers & (checkers - 1)) {
+        return; // Double check, only the king can move
+    }
+
+    // Out of check the pieces must capture the checker or block its ray
+    const BitBoard evasion = checkers ? MAGIC_BOARD.between_squares[king][lsb(checkers)] | checkers : BITBOARD_FULL;
+    const BitBoard targets = ~friendly & evasion & stage_mask;
+
+    const BitBoard queens = board.template get_piece_bitboard<QUEEN, Us>();
+    movegen_piece_moves<B, KNIGHT>(board.template get_piece_bitboard<KNIGHT, Us>(), occ, targets, pinned, king, sink);
+    movegen_piece_moves<B, BISHOP>(board.template get_piece_bitboard<BISHOP, Us>() | queens, occ, targets, pinned, king, sink);
+    movegen_piece_moves<B, ROOK>(board.template get_piece_bitboard<ROOK, Us>() | queens, occ, targets, pinned, king, sink);
+
+    // Pawns off the pin rays move as a set, one shift per direction. Promotions by push count as captures, they change the material just the same
+    const BitBoard pawns = board.template get_piece_bitboard<PAWN, Us>();
+    const BitBoard free_pawns = pawns & ~pinned;
+    const BitBoard single = bitboard_shift<up>(free_pawns) & empty;
+    if constexpr (G != GEN_QUIETS) {
+        sink.template add_pawns<Us, up - 1>(bitboard_shift<up - 1>(free_pawns & NotFileA) & enemy & evasion);
+        sink.template add_pawns<Us, up + 1>(bitboard_shift<up + 1>(free_pawns & NotFileH) & enemy & evasion);
+    }
+    if constexpr (G == GEN_CAPTURES) {
+        sink.template add_pawns<Us, up>(single & promotion_rank & evasion);
+    } else {
+        sink.template add_pawns<Us, up>((G == GEN_QUIETS ? single & ~promotion_rank : single) & evasion);
+        sink.template add_pawns<Us, 2 * up>(bitboard_shift<up>(single & DOUBLE_PUSH_RANKS[Us]) & empty & evasion);
+    }
+
+    // A pinned pawn can only move along the ray through its king
+    for (const auto from : BitBoardIterator(pawns & pinned)) {
+        const BitBoard reach = movegen_pawn_reach<Us>(board, from);
+        const BitBoard stage = G == GEN_CAPTURES ? enemy | promotion_rank : G == GEN_QUIETS ? empty & ~promotion_rank : BITBOARD_FULL;
+        sink.template add_pawn<Us>(from, reach & stage & evasion & MAGIC_BOARD.line_squares[king][from]);
+    }
+
+    if constexpr (G != GEN_QUIETS) {
+        movegen_en_passant<B, Us>(board, king, sink);
+    }
+
+    if (G != GEN_CAPTURES && !checkers) {
+        movegen_castles<B, Us>(board, sink);
+    }
+}
+
+// Stops at the first legal move. Castles are never needed: a legal castle implies the king can step onto the square next to it
+template <SliderBackend B, Color Us, typename Pos> static bool movegen_has_any(const Pos &board) {
+    constexpr Color them = ~Us;
+    constexpr int32_t up = PAWN_PUSH[Us];
+    const BitBoard occ = board.pieces_by_type[ANY];
+    const BitBoard friendly = board.pieces_by_color[Us];
+    const BitBoard king_bb = board.template get_piece_bitboard<KING, Us>();
+    const auto king = static_cast<SquareIndex>(lsb(king_bb));
+
+    for (const auto to : BitBoardIterator(MAGIC_BOARD.king_attacks[king] & ~friendly)) {
+        if (!movegen_attackers_to<B>(board, to, occ ^ king_bb, them)) {
+            return true;
+        }
+    }
+
+    const BitBoard checkers = movegen_checkers<B>(board, king, Us);
+    if (checkers & (checkers - 1)) {
+        return false;
+    }
+
+    const BitBoard pinned = movegen_pinned<B>(board, king, Us);
+    const BitBoard evasion = checkers ? MAGIC_BOARD.between_squares[king][lsb(checkers)] | checkers : BITBOARD_FULL;
+    const BitBoard targets = ~friendly & evasion;
+    const BitBoard empty = board.pieces_by_type[EMPTY];
+
+    const BitBoard pawns = board.template get_piece_bitboard<PAWN, Us>();
+    const BitBoard free_pawns = pawns & ~pinned;
+    const BitBoard single = bitboard_shift<up>(free_pawns) & empty;
+    const BitBoard double_push = bitboard_shift<up>(single & DOUBLE_PUSH_RANKS[Us]) & empty;
+    const BitBoard captures = (bitboard_shift<up - 1>(free_pawns & NotFileA) | bitboard_shift<up + 1>(free_pawns & NotFileH)) & board.pieces_by_color[them];
+    if ((single | double_push | captures) & evasion) {
+        return true;
+    }
+    for (const auto from : BitBoardIterator(pawns & pinned)) {
+        if (movegen_pawn_reach<Us>(board, from) & evasion & MAGIC_BOARD.line_squares[king][from]) {
+            return true;
+        }
+    }
+
+    for (const auto from : BitBoardIterator(board.template get_piece_bitboard<KNIGHT, Us>() & ~pinned)) {
+        if (movegen_attacks<B, KNIGHT>(from, occ) & targets) {
+            return true;
+        }
+    }
+
+    const BitBoard queens = board.template get_piece_bitboard<QUEEN, Us>();
+    for (const auto from : BitBoardIterator(board.template get_piece_bitboard<BISHOP, Us>() | queens)) {
+        const BitBoard pin_ray = bitboard_get(pinned, from) ? MAGIC_BOARD.line_squares[king][from] : BITBOARD_FULL;
+        if (movegen_attacks<B, BISHOP>(from, occ) & targets & pin_ray) {
+            return true;
+        }
+    }
+
+    for (const auto from : BitBoardIterator(board.template get_piece_bitboard<ROOK, Us>() | queens)) {
+        const BitBoard pin_ray = bitboard_get(pinned, from) ? MAGIC_BOARD.line_squares[king][from] : BITBOARD_FULL;
+        if (movegen_attacks<B, ROOK>(from, occ) & targets & pin_ray) {
+            return true;
+        }
+    }
+
+    MoveCountSink sink{};
+    movegen_en_passant<B, Us>(board, king, sink);
+    return sink.count != 0;
+}
+
+// Validates a move that may come from another position (hash table, killers) without generating the others
+template <SliderBackend B, Color Us, typename Pos> static bool movegen_is_legal(const Pos &board, const Move move) {
+    constexpr Color them = ~Us;
+    const SquareIndex from = move.get_origin_index();
+    const SquareIndex to = move.get_destination_index();
+    const Piece piece = movegen_piece_on(board, from);
+    if (PIECE_TYPE(piece) == EMPTY || PIECE_COLOR(piece) != Us || bitboard_get(board.pieces_by_color[Us], to)) {
+        return false;
+    }
+
+    const BitBoard king_bb = board.template get_piece_bitboard<KING, Us>();
+    const auto king = static_cast<SquareIndex>(lsb(king_bb));
+    const BitBoard occ = board.pieces_by_type[ANY];
+
+    // The special moves are rare here, the generators already encode their rules
+    if (move.is_castle() || move.is_en_passant()) {
+        MoveMatchSink sink{move};
+        if (move.is_en_passant()) {
+            movegen_en_passant<B, Us>(board, king, sink);
+        } else if (!movegen_checkers<B>(board, king, Us)) {
+            movegen_castles<B, Us>(board, sink);
+        }
+        return sink.found;
+    }
+
+    const BitBoard to_bb = bitboard_from_squares(to);
+    const bool promotes = PIECE_TYPE(piece) == PAWN && (to_bb & PROMOTION_RANKS[Us]);
+    if (move.is_promotion() != promotes || (!promotes && move.get_promotion_piece() != PROMOTION_QUEEN)) {
+        return false;
+    }
+
+    BitBoard reach = 0;
+    switch (PIECE_TYPE(piece)) {
+    case PAWN  : reach = movegen_pawn_reach<Us>(board, from); break;
+    case KNIGHT: reach = movegen_attacks<B, KNIGHT>(from, occ); break;
+    case BISHOP: reach = movegen_attacks<B, BISHOP>(from, occ); break;
+    case ROOK  : reach = movegen_attacks<B, ROOK>(from, occ); break;
+    case QUEEN : reach = movegen_attacks<B, QUEEN>(from, occ); break;
+    default    : return (MAGIC_BOARD.king_attacks[from] & to_bb) && !movegen_attackers_to<B>(board, to, occ ^ king_bb, them);
+    }
+    if (!(reach & to_bb)) {
+        return false;
+    }
+
+    const BitBoard checkers = movegen_checkers<B>(board, king, Us);
+    if (checkers && ((checkers & (checkers - 1)) || !(to_bb & (MAGIC_BOARD.between_squares[king][lsb(checkers)] | checkers)))) {
+        return false;
+    }
+    return !bitboard_get(movegen_pinned<B>(board, king, Us), from) || (MAGIC_BOARD.line_squares[king][from] & to_bb);
+}
+
+// The single dispatch on the side to move, everything below it is specialized for one color
+template <SliderBackend B, GenType G, typename Pos> static void movegen_generate_list(const Pos &board, MoveList &list) {
+    list.clear();
+    MoveListSink sink{list};
+    if (board.side_to_move == PIECE_WHITE) {
+        movegen_generate<B, G, PIECE_WHITE>(board, sink);
+    } else {
+        movegen_generate<B, G, PIECE_BLACK>(board, sink);
+    }
+}
+
+template <SliderBackend B, typename Pos> static int32_t movegen_count(const Pos &board) {
+    MoveCountSink sink{};
+    if (board.side_to_move == PIECE_WHITE) {
+        movegen_generate<B, GEN_ALL, PIECE_WHITE>(board, sink);
+    } else {
+        movegen_generate<B, GEN_ALL, PIECE_BLACK>(board, sink);
+    }
+    return sink.count;
+}
+
+template <SliderBackend B, typename Pos> static bool movegen_has_any_side(const Pos &board) {
+    return board.side_to_move == PIECE_WHITE ? movegen_has_any<B, PIECE_WHITE>(board) : movegen_has_any<B, PIECE_BLACK>(board);
+}
+
+template <SliderBackend B, typename Pos> static bool movegen_is_legal_side(const Pos &board, const Move move) {
+    return board.side_to_move == PIECE_WHITE ? movegen_is_legal<B, PIECE_WHITE>(board, move) : movegen_is_legal<B, PIECE_BLACK>(board, move);
+}
+
+template <GenType G, typename Pos> SLIDER_PEXT_ENTRY static void movegen_generate_list_pext(const Pos &board, MoveList &list) {
+    movegen_generate_list<SLIDER_PEXT, G>(board, list);
+}
+
+template <typename Pos> SLIDER_PEXT_ENTRY static int32_t movegen_count_pext(const Pos &board) { return movegen_count<SLIDER_PEXT>(board); }
+
+template <typename Pos> SLIDER_PEXT_ENTRY static bool movegen_has_any_pext(const Pos &board) { return movegen_has_any_side<SLIDER_PEXT>(board); }
+
+template <typename Pos> SLIDER_PEXT_ENTRY static bool movegen_is_legal_pext(const Pos &board, const Move move) { return movegen_is_legal_side<SLIDER_PEXT>(board, move); }
+
+template <typename Pos> static void movegen_generate_dispatch(const Pos &board, MoveList &list, const GenType type) {
+    switch (slider_backend) {
+    case SLIDER_PEXT:
+        switch (type) {
+        case GEN_CAPTURES: movegen_generate_list_pext<GEN_CAPTURES>(board, list); break;
+        case GEN_QUIETS  : movegen_generate_list_pext<GEN_QUIETS>(board, list); break;
+        default          : movegen_generate_list_pext<GEN_ALL>(board, list); break;
+        }
+        break;
+    case SLIDER_MAGIC_DIRECT:
+        switch (type) {
+        case GEN_CAPTURES: movegen_generate_list<SLIDER_MAGIC_DIRECT, GEN_CAPTURES>(board, list); break;
+        case GEN_QUIETS  : movegen_generate_list<SLIDER_MAGIC_DIRECT, GEN_QUIETS>(board, list); break;
+        default          : movegen_generate_list<SLIDER_MAGIC_DIRECT, GEN_ALL>(board, list); break;
+        }
+        break;
+    default:
+        switch (type) {
+        case GEN_CAPTURES: movegen_generate_list<SLIDER_MAGIC, GEN_CAPTURES>(board, list); break;
+        case GEN_QUIETS  : movegen_generate_list<SLIDER_MAGIC, GEN_QUIETS>(board, list); break;
+        default          : movegen_generate_list<SLIDER_MAGIC, GEN_ALL>(board, list); break;
+        }
+        break;
+    }
+}
+
+template <typename Pos> static int32_t movegen_count_dispatch(const Pos &board) {
+    switch (slider_backend) {
+    case SLIDER_PEXT        : return movegen_count_pext(board);
+    case SLIDER_MAGIC_DIRECT: return movegen_count<SLIDER_MAGIC_DIRECT>(board);
+    default                 : return movegen_count<SLIDER_MAGIC>(board);
+    }
+}
+
+template <typename Pos> static bool movegen_has_any_dispatch(const Pos &board) {
+    switch (slider_backend) {
+    case SLIDER_PEXT        : return movegen_has_any_pext(board);
+    case SLIDER_MAGIC_DIRECT: return movegen_has_any_side<SLIDER_MAGIC_DIRECT>(board);
+    default                 : return movegen_has_any_side<SLIDER_MAGIC>(board);
+    }
+}
+
+template <typename Pos> static bool movegen_is_legal_dispatch(const Pos &board, const Move move) {
+    switch (slider_backend) {
+    case SLIDER_PEXT        : return movegen_is_legal_pext(board, move);
+    case SLIDER_MAGIC_DIRECT: return movegen_is_legal_side<SLIDER_MAGIC_DIRECT>(board, move);
+    default                 : return movegen_is_legal_side<SLIDER_MAGIC>(board, move);
+    }
+}
+
+void generate_legal_moves(const Board &board, MoveList &list, const GenType type) { movegen_generate_dispatch(board, list, type); }
+
+void generate_legal_moves(const Position &pos, MoveList &list, const GenType type) { movegen_generate_dispatch(pos, list, type); }
+
+int32_t count_legal_moves(const Board &board) { return movegen_count_dispatch(board); }
+
+int32_t count_legal_moves(const Position &pos) { return movegen_count_dispatch(pos); }
+
+bool has_any_legal_move(const Board &board) { return movegen_has_any_dispatch(board); }
+
+bool has_any_legal_move(const Position &pos) { return movegen_has_any_dispatch(pos); }
+
+bool is_legal_move(const Board &board, const Move move) { return movegen_is_legal_dispatch(board, move); }
+
+bool is_legal_move(const Position &pos, const Move move) { return movegen_is_legal_dispatch(pos, move); }
+} // namespace game
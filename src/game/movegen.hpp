@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include "array.hpp"
+#include "bitboard.hpp"
+#include "board.hpp"
+#include "move.hpp"
+#include "position.hpp"
+
+namespace game {
+struct MoveList {
+    static constexpr int32_t MAX_MOVES = 256; // No legal position has more than 218 moves
+    gtr::array<Move, MAX_MOVES> moves;
+    int32_t count{0};
+
+    void push(const Move m) { moves[count++] = m; }
+    void clear() { count = 0; }
+    int32_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool contains(const Move m) const {
+        for (int32_t i = 0; i < count; ++i) {
+            if (moves[i] == m) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Move &operator[](const int32_t index) { return moves[index]; }
+    const Move &operator[](const int32_t index) const { return moves[index]; }
+
+    Move *begin() { return moves.data(); }
+    Move *end() { return moves.data() + count; }
+    const Move *begin() const { return moves.data(); }
+    const Move *end() const { return moves.data() + count; }
+};
+
+// Which part of the legal moves to generate. Captures include en passant and every promotion, quiets are the rest
+enum GenType : uint8_t { GEN_ALL, GEN_CAPTURES, GEN_QUIETS };
+
+/*
+ Generates every legal move for the side to move in a single pass.
+ Legality comes from the checkers bitboard, the pinned pieces and the evasion mask, the board is never modified.
+*/
+void generate_legal_moves(const Board &board, MoveList &list, GenType type = GEN_ALL);
+void generate_legal_moves(const Position &pos, MoveList &list, GenType type = GEN_ALL);
+
+// Same pass as generate_legal_moves, but destination sets are popcounted instead of materialized
+int32_t count_legal_moves(const Board &board);
+int32_t count_legal_moves(const Position &pos);
+
+// Mate and stalemate only need to know whether one legal move exists, this returns at the first one found
+bool has_any_legal_move(const Board &board);
+bool has_any_legal_move(const Position &pos);
+
+// Whether a move taken from elsewhere (hash table, killer slots) is legal here, without generating the other moves
+bool is_legal_move(const Board &board, Move move);
+bool is_legal_move(const Position &pos, Move move);
+} // namespace game
@@ -0,0 +1,244 @@
+#include "movepicker.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace game {
+static constexpr int32_t HISTORY_BONUS_MAX = 1536;
+
+static_assert(std::is_trivially_copyable_v<MoveOrdering>);
+
+// All zero bits are empty moves and neutral history
+void MoveOrdering::clear() { std::memset(static_cast<void *>(this), 0, sizeof(*this)); }
+
+// Moves the entry towards +-HISTORY_MAX by the bonus, less the closer it already is, so no entry ever saturates
+static void move_ordering_gravity(int16_t &entry, const int32_t bonus) {
+    entry = static_cast<int16_t>(entry + bonus - entry * std::abs(bonus) / HISTORY_MAX);
+}
+
+void move_ordering_update(MoveOrdering &ordering, const Color side, const int32_t ply, const int32_t depth, const Move previous, const Move best, const Move *tried,
+                          const int32_t tried_count) {
+    auto &killers = ordering.killers[ply];
+    if (killers[0] != best) {
+        killers[1] = killers[0];
+        killers[0] = best;
+    }
+    if (previous != Move{}) {
+        ordering.countermoves[previous.get_origin()][previous.get_destination()] = best;
+    }
+    const int32_t bonus = std::min(16 * depth * depth, HISTORY_BONUS_MAX);
+    auto &history = ordering.history[side];
+    move_ordering_gravity(history[best.get_origin()][best.get_destination()], bonus);
+    for (int32_t i = 0; i < tried_count; ++i) {
+        if (tried[i] != best) {
+            move_ordering_gravity(history[tried[i].get_origin()][tried[i].get_destination()], -bonus);
+        }
+    }
+}
+
+// The picker runs on Board and on Position, these cover the fields the two store differently
+static PieceType move_picker_type_on(const Board &board, const SquareIndex sq) { return PIECE_TYPE(board.pieces[sq]); }
+static PieceType move_picker_type_on(const Position &pos, const SquareIndex sq) { return PIECE_TYPE(position_piece_on(pos, sq)); }
+static Move move_picker_last_move(const Board &board) { return board.current_state->last_move; }
+static Move move_picker_last_move(const Position &pos) { return pos.last_move; }
+
+template <typename Pos>
+MovePicker<Pos>::MovePicker(const Pos &board, const Move tt_move, const Move killer_1, const Move killer_2)
+    : board(board), tt_move(tt_move), refutations{{killer_1, killer_2 == killer_1 ? Move{} : killer_2, Move{}}} {}
+
+template <typename Pos>
+MovePicker<Pos>::MovePicker(const Pos &board, const Move tt_move, const MoveOrdering &ordering, const int32_t ply)
+    : MovePicker(board, tt_move, ordering.killers[ply][0], ordering.killers[ply][1]) {
+    this->ordering = &ordering;
+    const Move previous = move_picker_last_move(board);
+    const Move countermove = previous != Move{} ? ordering.countermoves[previous.get_origin()][previous.get_destination()] : Move{};
+    if (countermove != refutations[0] && countermove != refutations[1]) {
+        refutations[2] = countermove;
+    }
+}
+
+template <typename Pos> MovePicker<Pos>::MovePicker(const Pos &board, const GenType gen) : board(board), refutations{}, stage(STAGE_CAPTURES_INIT), gen(gen) {}
+
+template <typename Pos> static int32_t move_picker_mvv_lva_on(const Pos &board, const Move move) {
+    const PieceType victim = move.is_en_passant() ? PAWN : move_picker_type_on(board, move.get_destination_index());
+    const int32_t promotion = move.is_promotion() ? move.get_promotion_piece_type() : EMPTY;
+    return 8 * (victim + promotion) - move_picker_type_on(board, move.get_origin_index());
+}
+
+int32_t move_picker_mvv_lva(const Board &board, const Move move) { return move_picker_mvv_lva_on(board, move); }
+
+int32_t move_picker_mvv_lva(const Position &pos, const Move move) { return move_picker_mvv_lva_on(pos, move); }
+
+// Refutations are quiet moves, a capture stored there was already handed out by the capture stage
+bool move_picker_is_quiet(const Board &board, const Move move) {
+    return !move.is_en_passant() && !move.is_promotion() && PIECE_TYPE(board.pieces[move.get_destination()]) == EMPTY;
+}
+
+bool move_picker_is_quiet(const Position &pos, const Move move) {
+    return !move.is_en_passant() && !move.is_promotion() && !bitboard_get(pos.pieces_by_type[ANY], move.get_destination_index());
+}
+
+/*
+ The swap loop: swap is what the side that just captured stands to lose if it is taken back, each side recaptures with
+ its least valuable attacker and the loop stops as soon as the side to recapture cannot get under the threshold.
+ The capturing piece leaves occ before it is looked at again, so the sliders behind it are found on the next lookup.
+*/
+template <SliderBackend B, typename Pos> static bool move_picker_see(const Pos &board, const Move move, const int32_t threshold) {
+    if (move.is_castle()) {
+        return threshold <= 0;
+    }
+    const SquareIndex from = move.get_origin_index();
+    const SquareIndex to = move.get_destination_index();
+    const SquareIndex captured = move.is_en_passant() ? static_cast<SquareIndex>((from & ~7) | (to & 7)) : to;
+    const int32_t promotion = move.is_promotion() ? SEE_VALUE[move.get_promotion_piece_type()] - SEE_VALUE[PAWN] : 0;
+    int32_t swap = SEE_VALUE[move_picker_type_on(board, captured)] + promotion - threshold;
+    if (swap < 0) {
+        return false;
+    }
+    swap = (move.is_promotion() ? SEE_VALUE[move.get_promotion_piece_type()] : SEE_VALUE[move_picker_type_on(board, from)]) - swap;
+    if (swap <= 0) {
+        return true;
+    }
+
+    BitBoard occ = (board.pieces_by_type[ANY] ^ bitboard_from_squares(from) ^ bitboard_from_squares(captured)) | bitboard_from_squares(to);
+    const BitBoard diagonals = board.pieces_by_type[BISHOP] | board.pieces_by_type[QUEEN];
+    const BitBoard lines = board.pieces_by_type[ROOK] | board.pieces_by_type[QUEEN];
+    BitBoard attackers = attackers_to<B>(board, to, occ);
+    Color side = board.side_to_move;
+    bool result = true;
+    while (true) {
+        side = ~side;
+        attackers &= occ;
+        const BitBoard ours = attackers & board.pieces_by_color[side];
+        if (!ours) {
+            break;
+        }
+        result = !result;
+        PieceType type = PAWN;
+        while (!(ours & board.pieces_by_type[type])) { type = static_cast<PieceType>(type + 1); }
+        if (type == KING) {
+            // The king may only take last, with an enemy attacker left the capture is illegal and the other side wins
+            return (attackers & board.pieces_by_color[~side]) ? !result : result;
+        }
+        swap = SEE_VALUE[type] - swap;
+        if (swap < static_cast<int32_t>(result)) {
+            break;
+        }
+        occ ^= bitboard_from_squares(static_cast<SquareIndex>(lsb(ours & board.pieces_by_type[type])));
+        if (type == PAWN || type == BISHOP || type == QUEEN) {
+            attackers |= MAGIC_BOARD.slider_attacks<BISHOP, B>(occ, to) & diagonals;
+        }
+        if (type == ROOK || type == QUEEN) {
+            attackers |= MAGIC_BOARD.slider_attacks<ROOK, B>(occ, to) & lines;
+        }
+    }
+    return result;
+}
+
+template <typename Pos> SLIDER_PEXT_ENTRY static bool move_picker_see_pext(const Pos &board, const Move move, const int32_t threshold) {
+    return move_picker_see<SLIDER_PEXT>(board, move, threshold);
+}
+
+template <typename Pos> static bool move_picker_see_dispatch(const Pos &board, const Move move, const int32_t threshold) {
+    switch (slider_backend) {
+    case SLIDER_PEXT        : return move_picker_see_pext(board, move, threshold);
+    case SLIDER_MAGIC_DIRECT: return move_picker_see<SLIDER_MAGIC_DIRECT>(board, move, threshold);
+    default                 : return move_picker_see<SLIDER_MAGIC>(board, move, threshold);
+    }
+}
+
+bool move_picker_see_ge(const Board &board, const Move move, const int32_t threshold) { return move_picker_see_dispatch(board, move, threshold); }
+
+bool move_picker_see_ge(const Position &pos, const Move move, const int32_t threshold) { return move_picker_see_dispatch(pos, move, threshold); }
+
+// Selection sort one move at a time from index on, the rest of the list stays unsorted if the node cuts off
+static void move_picker_select_best(MoveList &moves, gtr::array<int32_t, MoveList::MAX_MOVES> &scores, const int32_t index) {
+    int32_t best = index;
+    for (int32_t i = index + 1; i < moves.size(); ++i) {
+        if (scores[i] > scores[best]) {
+            best = i;
+        }
+    }
+    std::swap(moves[index], moves[best]);
+    std::swap(scores[index], scores[best]);
+}
+
+template <typename Pos> bool MovePicker<Pos>::next(Move &move) {
+    switch (stage) {
+    case STAGE_TT_MOVE:
+        stage = STAGE_CAPTURES_INIT;
+        if (tt_move != Move{} && is_legal_move(board, tt_move)) {
+            move = tt_move;
+            return true;
+        }
+        tt_move = Move{};
+        [[fallthrough]];
+
+    case STAGE_CAPTURES_INIT:
+        generate_legal_moves(board, moves, GEN_CAPTURES);
+        for (int32_t i = 0; i < moves.size(); ++i) { scores[i] = move_picker_mvv_lva(board, moves[i]); }
+        index = 0;
+        stage = STAGE_CAPTURES;
+        [[fallthrough]];
+
+    case STAGE_CAPTURES:
+        while (index < moves.size()) {
+            move_picker_select_best(moves, scores, index);
+            if (moves[index++] != tt_move) {
+                move = moves[index - 1];
+                return true;
+            }
+        }
+        if (gen == GEN_CAPTURES) {
+            stage = STAGE_DONE;
+            return false;
+        }
+        index = 0;
+        stage = STAGE_KILLERS;
+        [[fallthrough]];
+
+    case STAGE_KILLERS:
+        while (index < static_cast<int32_t>(refutations.size())) {
+            const Move refutation = refutations[index++];
+            if (refutation != Move{} && refutation != tt_move && move_picker_is_quiet(board, refutation) && is_legal_move(board, refutation)) {
+                move = refutation;
+                return true;
+            }
+        }
+        stage = STAGE_QUIETS_INIT;
+        [[fallthrough]];
+
+    case STAGE_QUIETS_INIT:
+        generate_legal_moves(board, moves, GEN_QUIETS);
+        if (ordering != nullptr) {
+            const auto &history = ordering->history[board.side_to_move];
+            for (int32_t i = 0; i < moves.size(); ++i) { scores[i] = history[moves[i].get_origin()][moves[i].get_destination()]; }
+        }
+        index = 0;
+        stage = STAGE_QUIETS;
+        [[fallthrough]];
+
+    case STAGE_QUIETS:
+        while (index < moves.size()) {
+            if (ordering != nullptr) {
+                move_picker_select_best(moves, scores, index);
+            }
+            const Move quiet = moves[index++];
+            if (quiet != tt_move && quiet != refutations[0] && quiet != refutations[1] && quiet != refutations[2]) {
+                move = quiet;
+                return true;
+            }
+        }
+        stage = STAGE_DONE;
+        [[fallthrough]];
+
+    case STAGE_DONE: return false;
+    }
+    return false;
+}
+
+template struct MovePicker<Board>;
+template struct MovePicker<Position>;
+} // namespace game
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include "array.hpp"
+#include "board.hpp"
+#include "move.hpp"
+#include "movegen.hpp"
+#include "position.hpp"
+
+namespace game {
+constexpr int32_t HISTORY_MAX = 16384; // The gravity update keeps every history entry within +-HISTORY_MAX
+
+// Material the static exchange evaluation trades in, indexed by piece type. The king is never captured, its 0 is unused
+constexpr gtr::array<int32_t, PIECE_COUNT + 1> SEE_VALUE = {0, 100, 300, 300, 500, 900, 0};
+
+/*
+ What a search thread learns about quiet moves while it searches. Plain arrays with no pointers, a thread owns one for
+ the whole search, so nothing is allocated at the nodes and a thread only ever touches its own lines.
+*/
+struct MoveOrdering {
+    static constexpr int32_t MAX_PLY = 128;
+
+    gtr::array<gtr::array<Move, 2>, MAX_PLY> killers;                                             // Last two quiet cutoffs of each ply, newest first
+    gtr::array<gtr::array<gtr::array<int16_t, SQUARE_COUNT>, SQUARE_COUNT>, COLOR_COUNT> history; // Butterfly table [color][from][to]
+    gtr::array<gtr::array<Move, SQUARE_COUNT>, SQUARE_COUNT> countermoves;                        // Quiet refutation of the previous move [from][to]
+
+    void clear();
+};
+
+// A quiet move cut off: it becomes a killer of the ply and the countermove of the previous move, its history goes up and
+// the history of the quiet moves tried before it goes down, both by a bonus growing with the depth
+void move_ordering_update(MoveOrdering &ordering, Color side, int32_t ply, int32_t depth, Move previous, Move best, const Move *tried, int32_t tried_count);
+
+/*
+ Hands out the legal moves of a position one at a time, in the order alpha-beta wants to try them:
+ the transposition table move, captures by most valuable victim / least valuable attacker, the killer moves and the
+ countermove, then the quiet moves by history. A stage is only generated once the previous one is used up, so a node
+ that cuts off early never generates its quiet moves. A GEN_CAPTURES picker stops after the captures, for quiescence.
+ Instantiated for Board and for the Position search copy-makes.
+*/
+template <typename Pos> struct MovePicker {
+    enum Stage : uint8_t { STAGE_TT_MOVE, STAGE_CAPTURES_INIT, STAGE_CAPTURES, STAGE_KILLERS, STAGE_QUIETS_INIT, STAGE_QUIETS, STAGE_DONE };
+
+    const Pos &board;
+    const MoveOrdering *ordering{nullptr}; // Without one the quiet moves come in generation order
+    Move tt_move{}; // Empty for the quiescence picker, which starts past the tt move stage
+    gtr::array<Move, 3> refutations; // Both killers, then the countermove
+    MoveList moves;
+    gtr::array<int32_t, MoveList::MAX_MOVES> scores;
+    int32_t index{0};
+    Stage stage{STAGE_TT_MOVE};
+    GenType gen{GEN_ALL};
+
+    // Any of the hint moves may be empty, illegal or repeated, they are validated before being returned
+    MovePicker(const Pos &board, Move tt_move, Move killer_1 = Move{}, Move killer_2 = Move{});
+
+    // Killers of the ply and the countermove of the board's last move come from the thread's tables
+    MovePicker(const Pos &board, Move tt_move, const MoveOrdering &ordering, int32_t ply);
+
+    // Captures and promotions only, GEN_ALL gives every legal move with no hints
+    MovePicker(const Pos &board, GenType gen);
+
+    // Next move in picking order, false once every legal move was returned
+    bool next(Move &move);
+};
+
+// Victim value minus attacker value, promotions score as capturing the new piece
+int32_t move_picker_mvv_lva(const Board &board, Move move);
+int32_t move_picker_mvv_lva(const Position &pos, Move move);
+
+// Neither a capture nor a promotion, the moves the ordering tables learn from
+bool move_picker_is_quiet(const Board &board, Move move);
+bool move_picker_is_quiet(const Position &pos, Move move);
+
+// Static exchange evaluation: whether the side to move wins at least threshold once both sides have recaptured on the
+// destination with their least valuable attacker for as long as it pays. X-rays join as pieces leave the square's lines,
+// pins are not looked at and castles count as 0
+bool move_picker_see_ge(const Board &board, Move move, int32_t threshold);
+bool move_picker_see_ge(const Position &pos, Move move, int32_t threshold);
+} // namespace game
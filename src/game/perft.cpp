@@ -0,0 +1,262 @@
+#include "perft.hpp"
+#include <atomic>
+#include <bit>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "board.hpp"
+#include "movegen.hpp"
+#include "random.hpp"
+#include "vector.hpp"
+
+namespace game {
+uint64_t perft(Board &board, const int32_t depth) {
+    if (depth <= 0) {
+        return 1;
+    }
+    if (depth == 1) {
+        return static_cast<uint64_t>(count_legal_moves(board));
+    }
+    MoveList list;
+    generate_legal_moves(board, list);
+    uint64_t nodes = 0;
+    for (const auto move : list) {
+        BoardState state{};
+        board.move_stateless(move, state);
+        nodes += perft(board, depth - 1);
+        board.undo_stateless(state);
+    }
+    return nodes;
+}
+
+void perft_divide(Board &board, const int32_t depth, PerftDivide &out) {
+    generate_legal_moves(board, out.moves);
+    out.total = 0;
+    for (int32_t i = 0; i < out.moves.size(); ++i) {
+        BoardState state{};
+        board.move_stateless(out.moves[i], state);
+        out.nodes[i] = perft(board, depth - 1);
+        board.undo_stateless(state);
+        out.total += out.nodes[i];
+    }
+}
+
+uint64_t perft(const Position &pos, const int32_t depth) {
+    if (depth <= 0) {
+        return 1;
+    }
+    if (depth == 1) {
+        return static_cast<uint64_t>(count_legal_moves(pos));
+    }
+    MoveList list;
+    generate_legal_moves(pos, list);
+    uint64_t nodes = 0;
+    for (const auto move : list) {
+        Position child = pos;
+        position_make_move(child, move);
+        nodes += perft(child, depth - 1);
+    }
+    return nodes;
+}
+
+void perft_divide(const Position &pos, const int32_t depth, PerftDivide &out) {
+    generate_legal_moves(pos, out.moves);
+    out.total = 0;
+    for (int32_t i = 0; i < out.moves.size(); ++i) {
+        Position child = pos;
+        position_make_move(child, out.moves[i]);
+        out.nodes[i] = perft(child, depth - 1);
+        out.total += out.nodes[i];
+    }
+}
+
+static constexpr int32_t PERFT_MAX_DEPTH = 64;
+static constexpr int32_t PERFT_MAX_SPLIT_PLY = 16;
+static constexpr int32_t PERFT_MIN_SPLIT_DEPTH = 3; // Smaller subtrees finish faster than a steal round trip
+
+// The same position at different depths must not share an entry
+static constexpr auto PERFT_DEPTH_KEYS = [] {
+    gtr::array<uint64_t, PERFT_MAX_DEPTH> keys{};
+    detail::RandomGenerator rng{0xD1B54A32D192ED03ULL};
+    for (auto &key : keys) { key = rng(); }
+    return keys;
+}();
+
+struct PerftHashEntry {
+    std::atomic<uint64_t> check{0}; // key ^ nodes, a torn write from another thread fails the check
+    std::atomic<uint64_t> nodes{0};
+};
+
+struct PerftHashTable {
+    std::unique_ptr<PerftHashEntry[]> entries;
+    uint64_t mask{0};
+
+    explicit PerftHashTable(const uint64_t mb) {
+        if (mb == 0) {
+            return;
+        }
+        const uint64_t count = std::bit_floor(mb * 1024 * 1024 / sizeof(PerftHashEntry));
+        entries = std::make_unique<PerftHashEntry[]>(count);
+        mask = count - 1;
+    }
+
+    bool enabled() const { return entries != nullptr; }
+
+    bool probe(const uint64_t key, uint64_t &nodes) const {
+        const PerftHashEntry &entry = entries[key & mask];
+        const uint64_t n = entry.nodes.load(std::memory_order_relaxed);
+        if ((entry.check.load(std::memory_order_relaxed) ^ n) != key) {
+            return false;
+        }
+        nodes = n;
+        return true;
+    }
+
+    void store(const uint64_t key, const uint64_t nodes) {
+        PerftHashEntry &entry = entries[key & mask];
+        entry.check.store(key ^ nodes, std::memory_order_relaxed);
+        entry.nodes.store(nodes, std::memory_order_relaxed);
+    }
+};
+
+static uint64_t perft_hashed(PositionStack &stack, const int32_t depth, PerftHashTable &table) {
+    if (depth <= 1 || !table.enabled()) {
+        return perft(stack.current(), depth);
+    }
+    const uint64_t key = stack.current().key ^ PERFT_DEPTH_KEYS[depth];
+    uint64_t nodes = 0;
+    if (table.probe(key, nodes)) {
+        return nodes;
+    }
+    MoveList list;
+    generate_legal_moves(stack.current(), list);
+    for (const auto move : list) {
+        stack.make(move);
+        nodes += perft_hashed(stack, depth - 1, table);
+        stack.unmake();
+    }
+    table.store(key, nodes);
+    return nodes;
+}
+
+// A subtree identified by the moves leading to it from the root
+struct PerftTask {
+    gtr::array<Move, PERFT_MAX_SPLIT_PLY> path;
+    int32_t length{0};
+    int32_t root_index{0};
+};
+
+struct PerftWorkQueue {
+    std::mutex mutex;
+    std::deque<PerftTask> tasks;
+};
+
+struct PerftContext {
+    Position root;
+    int32_t depth;
+    PerftHashTable table;
+    std::unique_ptr<PerftWorkQueue[]> queues;
+    int32_t queue_count;
+    gtr::array<std::atomic<uint64_t>, MoveList::MAX_MOVES> root_nodes{};
+    std::atomic<int64_t> pending{0}; // Tasks queued or running, workers leave when it reaches zero
+    std::atomic<int32_t> idle{0};
+};
+
+static bool perft_take_task(PerftContext &ctx, const int32_t worker, PerftTask &task) {
+    {
+        PerftWorkQueue &own = ctx.queues[worker];
+        std::scoped_lock lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (int32_t i = 1; i < ctx.queue_count; ++i) {
+        PerftWorkQueue &victim = ctx.queues[(worker + i) % ctx.queue_count];
+        std::scoped_lock lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+static void perft_run_task(PerftContext &ctx, const int32_t worker, PositionStack &stack, const PerftTask &task) {
+    stack.reset(ctx.root);
+    for (int32_t i = 0; i < task.length; ++i) { stack.make(task.path[i]); }
+
+    const int32_t remaining = ctx.depth - task.length;
+    if (remaining >= PERFT_MIN_SPLIT_DEPTH && task.length < PERFT_MAX_SPLIT_PLY && ctx.idle.load(std::memory_order_relaxed) > 0) {
+        MoveList list;
+        generate_legal_moves(stack.current(), list);
+        // Account for the children before this task retires, so pending never touches zero early
+        ctx.pending.fetch_add(list.size() - 1);
+        PerftWorkQueue &own = ctx.queues[worker];
+        std::scoped_lock lock(own.mutex);
+        for (const auto move : list) {
+            PerftTask child = task;
+            child.path[child.length++] = move;
+            own.tasks.push_back(child);
+        }
+    } else {
+        ctx.root_nodes[task.root_index].fetch_add(perft_hashed(stack, remaining, ctx.table), std::memory_order_relaxed);
+        ctx.pending.fetch_sub(1);
+    }
+}
+
+static void perft_worker(PerftContext &ctx, const int32_t worker) {
+    const auto stack = std::make_unique<PositionStack>(); // Allocated once, every task replays its path onto it
+    bool idle = false;
+    while (ctx.pending.load() > 0) {
+        PerftTask task;
+        if (perft_take_task(ctx, worker, task)) {
+            if (idle) {
+                ctx.idle.fetch_sub(1);
+                idle = false;
+            }
+            perft_run_task(ctx, worker, *stack, task);
+        } else {
+            if (!idle) {
+                ctx.idle.fetch_add(1);
+                idle = true;
+            }
+            std::this_thread::yield();
+        }
+    }
+}
+
+void perft_parallel(const Board &board, const int32_t depth, const PerftOptions &options, PerftDivide &out) {
+    if (depth <= 1 || depth >= PERFT_MAX_DEPTH) {
+        Board copy = board;
+        perft_divide(copy, depth, out);
+        return;
+    }
+    const int32_t threads = options.threads < 1 ? 1 : options.threads;
+    PerftContext ctx{position_from_board(board), depth, PerftHashTable{options.hash_mb}, std::make_unique<PerftWorkQueue[]>(threads), threads};
+
+    generate_legal_moves(board, out.moves);
+    ctx.pending.store(out.moves.size());
+    for (int32_t i = 0; i < out.moves.size(); ++i) {
+        PerftTask task;
+        task.path[0] = out.moves[i];
+        task.length = 1;
+        task.root_index = i;
+        ctx.queues[i % threads].tasks.push_back(task);
+    }
+
+    gtr::vector<std::thread> workers;
+    for (int32_t i = 1; i < threads; ++i) { workers.emplace_back(perft_worker, std::ref(ctx), i); }
+    perft_worker(ctx, 0);
+    for (auto &worker : workers) { worker.join(); }
+
+    out.total = 0;
+    for (int32_t i = 0; i < out.moves.size(); ++i) {
+        out.nodes[i] = ctx.root_nodes[i].load();
+        out.total += out.nodes[i];
+    }
+}
+} // namespace game
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include "array.hpp"
+#include "board.hpp"
+#include "movegen.hpp"
+#include "position.hpp"
+
+namespace game {
+struct PerftDivide {
+    MoveList moves;
+    gtr::array<uint64_t, MoveList::MAX_MOVES> nodes{}; // Leaf count below each root move, same order as moves
+    uint64_t total{0};
+};
+
+// Leaf nodes at the given depth. The last ply is bulk counted, so no make/unmake happens on it
+uint64_t perft(Board &board, int32_t depth);
+
+// Same count as perft, split per root move
+void perft_divide(Board &board, int32_t depth, PerftDivide &out);
+
+// Copy-make versions on a Position, every child is a copy of its parent with the move applied
+uint64_t perft(const Position &pos, int32_t depth);
+void perft_divide(const Position &pos, int32_t depth, PerftDivide &out);
+
+struct PerftOptions {
+    int32_t threads{1};
+    uint64_t hash_mb{0}; // Size of the shared (position, depth) -> count table, 0 disables it
+};
+
+/*
+ Multithreaded perft_divide. Root moves are dealt round robin to per-thread queues, a worker that runs dry steals the
+ oldest (largest) task from another queue, and busy workers split their subtree one ply further while someone is idle.
+ Every worker probes and fills the same lock-free table, entries are verified by xoring the key with the count.
+*/
+void perft_parallel(const Board &board, int32_t depth, const PerftOptions &options, PerftDivide &out);
+} // namespace game
@@ -1,5 +1,6 @@
 #include "player.hpp"
 #include "analyzer.hpp"
+#include <chrono>
 #include <random>
 
 namespace game {
@@ -57,4 +58,35 @@ Move DrunkMan::get_move(Board &b) {
     }
     return {};
 }
+
+SearcherJob::~SearcherJob() {
+    stop.store(true, std::memory_order_relaxed);
+    if (result.valid()) {
+        result.wait();
+    }
+}
+
+Move Searcher::get_move(Board &b) {
+    if (job != nullptr && job->board_version != b.version) {
+        job.reset(); // Searching a position that is gone
+    }
+    if (job == nullptr) {
+        if (table == nullptr) {
+            table = std::make_shared<TranspositionTable>(hash_mb);
+        }
+        job = std::make_shared<SearcherJob>();
+        job->board_version = b.version;
+        SearchLimits job_limits = limits;
+        job_limits.stop = &job->stop;
+        // The worker owns its board copy and a reference on the table, the job outlives it since its destructor waits
+        job->result = std::async(std::launch::async, [board = b, job_limits, table = table] { return search(board, job_limits, *table); });
+        return {};
+    }
+    if (job->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return {};
+    }
+    last_search = job->result.get();
+    job.reset();
+    return last_search.best_move;
+}
 } // namespace game
@@ -1,8 +1,12 @@
 #pragma once
+#include <atomic>
+#include <future>
+#include <memory>
 #include <random>
 #include <variant>
 #include "move.hpp"
 #include "piece.hpp"
+#include "search.hpp"
 
 namespace game {
 struct PlayerStatus {
@@ -33,7 +37,34 @@ struct DrunkMan {
     Move get_move(Board &b);
 };
 
-using Player = std::variant<Human, DrunkMan>;
+// One search running on a worker thread, for the board version it was started from
+struct SearcherJob {
+    std::atomic<bool> stop{false};
+    std::future<SearchResult> result;
+    uint64_t board_version{0};
+
+    // Raises stop and waits for the worker, an abandoned search ends within a few thousand nodes
+    ~SearcherJob();
+};
+
+// Plays the best move of an alpha-beta search within its limits, the report of the last search is kept for display.
+// The transposition table is created on the first move and kept for the whole game, copies of the player share it.
+struct Searcher {
+    PlayerStatus player{};
+    SearchLimits limits{.depth = SEARCH_MAX_PLY - 1, .nodes = 0, .time_ms = 1000};
+    uint64_t hash_mb{16};
+    std::shared_ptr<TranspositionTable> table{};
+    std::shared_ptr<SearcherJob> job{};
+    SearchResult last_search{};
+
+    void init(const Color c) { player.color = c; }
+
+    // Never waits for the search: the first call starts it on a copy of the board and every call returns an empty move
+    // until it is done. Game::tick polls it once per frame. A board that changed in between gets a new search.
+    Move get_move(Board &b);
+};
+
+using Player = std::variant<Human, DrunkMan, Searcher>;
 
 inline bool player_is_ai(const Player &p) { return !std::holds_alternative<Human>(p); }
 
@@ -0,0 +1,136 @@
+#include "position.hpp"
+#include "board.hpp"
+#include "fen.hpp"
+#include "zobrist.hpp"
+
+namespace game {
+static constexpr gtr::array PAWN_PUSH = {static_cast<int32_t>(BLACK_DIRECTION), static_cast<int32_t>(WHITE_DIRECTION)};
+
+Piece position_piece_on(const Position &pos, const SquareIndex sq) {
+    const BitBoard bb = bitboard_from_squares(sq);
+    if (!(pos.pieces_by_type[ANY] & bb)) {
+        return PIECE_NONE;
+    }
+    int32_t type = PAWN;
+    while (!(pos.pieces_by_type[type] & bb)) { ++type; }
+    return chess_piece_make(static_cast<PieceType>(type), pos.pieces_by_color[PIECE_BLACK] & bb ? PIECE_BLACK : PIECE_WHITE);
+}
+
+template <SliderBackend B> static BitBoard position_checkers(const Position &pos) {
+    const Color us = pos.side_to_move;
+    const BitBoard king = pos.get_piece_bitboard(KING, us);
+    return king ? attackers_to<B>(pos, static_cast<SquareIndex>(lsb(king)), pos.pieces_by_type[ANY]) & pos.pieces_by_color[~us] : 0;
+}
+
+SLIDER_PEXT_ENTRY static BitBoard position_checkers_pext(const Position &pos) { return position_checkers<SLIDER_PEXT>(pos); }
+
+BitBoard position_checkers(const Position &pos) {
+    switch (slider_backend) {
+    case SLIDER_PEXT        : return position_checkers_pext(pos);
+    case SLIDER_MAGIC_DIRECT: return position_checkers<SLIDER_MAGIC_DIRECT>(pos);
+    default                 : return position_checkers<SLIDER_MAGIC>(pos);
+    }
+}
+
+template <EvalPolicy E> static void position_toggle(Position &pos, const Piece piece, const SquareIndex sq) {
+    const BitBoard bb = bitboard_from_squares(sq);
+    pos.pieces_by_type[PIECE_TYPE(piece)] ^= bb;
+    pos.pieces_by_color[PIECE_COLOR(piece)] ^= bb;
+    pos.pieces_by_type[ANY] ^= bb;
+    pos.pieces_by_type[EMPTY] ^= bb;
+    pos.key ^= ZOBRIST.pieces[piece][sq];
+    if constexpr (E == EVAL_INCREMENTAL) {
+        if (pos.pieces_by_type[ANY] & bb) {
+            eval_put(pos.eval, piece, sq);
+        } else {
+            eval_remove(pos.eval, piece, sq);
+        }
+    }
+}
+
+template <EvalPolicy E> static void position_move_piece(Position &pos, const Piece piece, const SquareIndex from, const SquareIndex to) {
+    const BitBoard bb = bitboard_from_squares(from, to);
+    pos.pieces_by_type[PIECE_TYPE(piece)] ^= bb;
+    pos.pieces_by_color[PIECE_COLOR(piece)] ^= bb;
+    pos.pieces_by_type[ANY] ^= bb;
+    pos.pieces_by_type[EMPTY] ^= bb;
+    pos.key ^= ZOBRIST.pieces[piece][from] ^ ZOBRIST.pieces[piece][to];
+    if constexpr (E == EVAL_INCREMENTAL) {
+        eval_move(pos.eval, piece, from, to);
+    }
+}
+
+template <EvalPolicy E> void position_make_move(Position &pos, const Move move) {
+    const Color us = pos.side_to_move;
+    const SquareIndex from = move.get_origin_index();
+    const SquareIndex to = move.get_destination_index();
+    const Piece piece = position_piece_on(pos, from);
+
+    pos.key ^= ZOBRIST.side ^ ZOBRIST.castle[std::to_underlying(pos.castle_rights)] ^ zobrist_en_passant(pos, pos.en_passant_index, us);
+    pos.en_passant_index = EN_PASSANT_INVALID_INDEX;
+    pos.last_move = move;
+    ++pos.halfmove_clock;
+
+    switch (move.get_special()) {
+    case Move::MOVE_CASTLE: {
+        const bool king_side = to > from;
+        const auto rook_from = static_cast<SquareIndex>(king_side ? to + 1 : to - 2);
+        const auto rook_to = static_cast<SquareIndex>(king_side ? to - 1 : to + 1);
+        position_move_piece<E>(pos, piece, from, to);
+        position_move_piece<E>(pos, chess_piece_make(ROOK, us), rook_from, rook_to);
+    } break;
+    case Move::MOVE_EN_PASSANT:
+        position_toggle<E>(pos, chess_piece_make(PAWN, ~us), static_cast<SquareIndex>(to - PAWN_PUSH[us]));
+        position_move_piece<E>(pos, piece, from, to);
+        pos.halfmove_clock = 0;
+        break;
+    default: {
+        if (const Piece captured = position_piece_on(pos, to); captured != PIECE_NONE) {
+            position_toggle<E>(pos, captured, to);
+            pos.halfmove_clock = 0;
+        }
+        if (move.is_promotion()) {
+            position_toggle<E>(pos, piece, from);
+            position_toggle<E>(pos, chess_piece_make(move.get_promotion_piece_type(), us), to);
+        } else {
+            position_move_piece<E>(pos, piece, from, to);
+        }
+        if (PIECE_TYPE(piece) == PAWN) {
+            pos.halfmove_clock = 0;
+            if (to - from == 2 * PAWN_PUSH[us]) {
+                pos.en_passant_index = static_cast<int8_t>(from + PAWN_PUSH[us]);
+            }
+        }
+    } break;
+    }
+
+    pos.castle_rights &= CASTLE_RIGHTS_MASK[from] & CASTLE_RIGHTS_MASK[to];
+    pos.side_to_move = ~us;
+    ++pos.move_count;
+    pos.key ^= ZOBRIST.castle[std::to_underlying(pos.castle_rights)] ^ zobrist_en_passant(pos, pos.en_passant_index, ~us);
+}
+
+template void position_make_move<EVAL_NONE>(Position &, Move);
+template void position_make_move<EVAL_INCREMENTAL>(Position &, Move);
+
+Position position_from_board(const Board &board) {
+    Position pos{};
+    pos.pieces_by_type = board.pieces_by_type;
+    pos.pieces_by_color = board.pieces_by_color;
+    pos.key = board.current_state->key;
+    pos.move_count = static_cast<uint16_t>(board.move_count);
+    pos.halfmove_clock = board.current_state->halfmove_clock;
+    pos.last_move = board.current_state->last_move;
+    pos.castle_rights = board.current_state->castle_rights;
+    pos.en_passant_index = board.current_state->en_passant_index;
+    pos.side_to_move = board.side_to_move;
+    pos.eval = eval_compute(pos);
+    return pos;
+}
+
+void position_to_board(const Position &pos, Board &board) {
+    gtr::array<Piece, SQUARE_COUNT> pieces{};
+    for (const auto sq : BitBoardIterator(pos.pieces_by_type[ANY])) { pieces[sq] = position_piece_on(pos, sq); }
+    board.set_position(Fen::build(pieces, pos.side_to_move, pos.castle_rights, pos.en_passant_index, pos.halfmove_clock, pos.move_count + 1)); // Same fullmove convention as Board::get_fen
+}
+} // namespace game
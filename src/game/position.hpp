@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+#include "array.hpp"
+#include "bitboard.hpp"
+#include "eval.hpp"
+#include "move.hpp"
+#include "piece.hpp"
+#include "types.hpp"
+#include "utils.hpp"
+
+namespace game {
+struct Board;
+
+/*
+ Search side position: only the bitboards and the irreversible state, two cache lines, no history and no pointers.
+ Search and perft copy-make it (copy the parent, apply the move on the copy), so there is nothing to undo and a position
+ can be handed to another thread by value. The game history it leaves out is passed to search as a list of keys.
+*/
+struct alignas(64) Position {
+    gtr::array<BitBoard, PIECE_COUNT_PLUS_ANY> pieces_by_type; // Same layout as Board, EMPTY holds the empty squares
+    gtr::array<BitBoard, COLOR_COUNT> pieces_by_color;
+    uint64_t key;
+    EvalState eval;          // Only kept up to date by moves made with EVAL_INCREMENTAL, position_from_board computes it
+    uint16_t move_count;     // Plies since the start of the game, like Board::move_count
+    uint16_t halfmove_clock; // Plies since the last capture or pawn move, as wide as Board's so long games do not wrap
+    Move last_move;          // Move that led here, the countermove slot of the move ordering is looked up from it
+    std::byte castle_rights;
+    int8_t en_passant_index;
+    Color side_to_move;
+
+    template <PieceType T, Color C> constexpr BitBoard get_piece_bitboard() const { return pieces_by_type[T] & pieces_by_color[C]; }
+
+    constexpr BitBoard get_piece_bitboard(const PieceType t, const Color c) const { return pieces_by_type[t] & pieces_by_color[c]; }
+};
+static_assert(std::is_trivially_copyable_v<Position>);
+static_assert(sizeof(Position) == 128, "Position should stay within two cache lines");
+
+// Applies a legal move in place, callers keep the parent by copying it first
+template <EvalPolicy E = EVAL_NONE> void position_make_move(Position &pos, Move move);
+
+/*
+ Ply-indexed positions for one search thread or perft_parallel worker, allocated once and reused for every search or task.
+ Make copies the current entry one slot up and applies the move there, unmake only steps the index back:
+ no allocation, no redo timeline to truncate and no state pointer to re-fetch.
+*/
+struct PositionStack {
+    static constexpr int32_t MAX_PLY = 256;
+
+    gtr::array<Position, MAX_PLY + 1> positions;
+    int32_t ply{0};
+
+    void reset(const Position &root) {
+        positions[0] = root;
+        ply = 0;
+    }
+
+    const Position &current() const { return positions[ply]; }
+
+    template <EvalPolicy E = EVAL_NONE> void make(const Move move) {
+        Assert(ply < MAX_PLY, "Position stack overflow");
+        positions[ply + 1] = positions[ply];
+        position_make_move<E>(positions[ply + 1], move);
+        ++ply;
+    }
+
+    void unmake() {
+        Assert(ply > 0, "Position stack underflow");
+        --ply;
+    }
+};
+
+// Piece on a square, found from the bitboards since Position keeps no mailbox
+Piece position_piece_on(const Position &pos, SquareIndex sq);
+
+// Enemy pieces giving check to the side to move. Position caches no check info, this is an attackers_to lookup per call
+BitBoard position_checkers(const Position &pos);
+
+Position position_from_board(const Board &board);
+
+// Sets the board to the position, its history starts over from there
+void position_to_board(const Position &pos, Board &board);
+} // namespace game
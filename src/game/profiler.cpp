@@ -0,0 +1,4 @@
+#include "profiler.hpp"
+#include <cstdint>
+gtr::profiler::profiler gtr::profiler::GlobalProfiler;
+uint32_t gtr::profiler::GlobalProfilerParent;
@@ -0,0 +1,77 @@
+#include "repetition.hpp"
+#include <algorithm>
+#include "board.hpp"
+
+namespace game {
+int32_t repetition_count(const uint64_t *keys, const int32_t count, const int32_t window) {
+    const uint64_t current = keys[count - 1];
+    const int32_t end = std::min(window, count - 1);
+    int32_t repetitions = 0;
+    // Two plies back cannot match, both sides would have had to pass
+    for (int32_t back = 4; back <= end; back += 2) { repetitions += keys[count - 1 - back] == current; }
+    return repetitions;
+}
+
+bool repetition_upcoming(const uint64_t *keys, const int32_t count, const int32_t window, const BitBoard occupied, const int32_t ply) {
+    const uint64_t current = keys[count - 1];
+    const int32_t end = std::min({window, count - 1, ply - 1});
+    // Odd plies back the other side was to move, one move of ours away from it
+    for (int32_t back = 3; back <= end; back += 2) {
+        const uint64_t move_key = current ^ keys[count - 1 - back];
+        uint32_t slot = cuckoo_h1(move_key);
+        if (CUCKOO.keys[slot] != move_key) {
+            slot = cuckoo_h2(move_key);
+            if (CUCKOO.keys[slot] != move_key) {
+                continue;
+            }
+        }
+        const Move move = CUCKOO.moves[slot];
+        if (!(MAGIC_BOARD.between_squares[move.get_origin_index()][move.get_destination_index()] & occupied)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Calls visit(key, back) for the states back plies before the board's current one, newest first, up to window plies
+template <typename Visit> static void board_walk_keys(const Board &board, const int32_t window, Visit visit) {
+    // Stateless moves chain through previous down to the timeline's current state, the timeline itself is walked by index
+    const BoardState *state = board.current_state;
+    const BoardState *const timeline = board.state_history.current();
+    bool on_timeline = state == timeline;
+    uint64_t index = board.state_history.read_index;
+    for (int32_t back = 1; back <= window; ++back) {
+        if (!on_timeline) {
+            if (state->previous == nullptr) {
+                break;
+            }
+            state = state->previous;
+            on_timeline = state == timeline;
+        } else if (index == 0) {
+            break;
+        } else {
+            state = &board.state_history[--index];
+        }
+        visit(state->key, back);
+    }
+}
+
+int32_t board_repetition_count(const Board &board) {
+    const uint64_t current = board.current_state->key;
+    int32_t repetitions = 0;
+    board_walk_keys(board, board.current_state->halfmove_clock, [&](const uint64_t key, const int32_t back) { repetitions += back >= 4 && back % 2 == 0 && key == current; });
+    return repetitions;
+}
+
+int32_t board_key_history(const Board &board, uint64_t *keys, const int32_t max) {
+    const int32_t window = std::min<int32_t>(board.current_state->halfmove_clock, max);
+    int32_t count = 0;
+    board_walk_keys(board, window, [&](const uint64_t key, const int32_t back) {
+        keys[window - back] = key;
+        count = back;
+    });
+    // A timeline shorter than the window filled only the tail
+    std::copy(keys + window - count, keys + window, keys);
+    return count;
+}
+} // namespace game
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include "array.hpp"
+#include "bitboard.hpp"
+#include "move.hpp"
+
+namespace game {
+struct Board;
+
+// A draw once this many plies pass without a capture or a pawn move
+constexpr int32_t FIFTY_MOVE_RULE_PLIES = 100;
+
+/*
+ Repetitions are found from Zobrist keys alone. A capture or a pawn move can never be undone, so only the positions
+ since the last one, the halfmove clock window, are compared, and only every other ply, the ones with the same side to move.
+ The key lists run oldest first, keys[count - 1] being the current position.
+*/
+
+constexpr int32_t CUCKOO_SIZE = 8192;
+
+constexpr uint32_t cuckoo_h1(const uint64_t key) { return key & (CUCKOO_SIZE - 1); }
+
+constexpr uint32_t cuckoo_h2(const uint64_t key) { return (key >> 16) & (CUCKOO_SIZE - 1); }
+
+// Key difference of every reversible single piece move, that is the piece on both squares and the side, and the move.
+// A move and its reverse share a slot, they toggle the same keys. Filled by magic_gen next to MAGIC_BOARD.
+struct CuckooTable {
+    gtr::array<uint64_t, CUCKOO_SIZE> keys;
+    gtr::array<Move, CUCKOO_SIZE> moves;
+};
+
+extern const CuckooTable CUCKOO;
+
+// Earlier occurrences of the current position within the last window plies
+int32_t repetition_count(const uint64_t *keys, int32_t count, int32_t window);
+
+// Whether the side to move has a move that goes back to a position of the window, so search can score the draw one ply
+// early. Looks up the key difference to each earlier position in a cuckoo table of every single piece move, and checks
+// the path of the move is empty in occupied. Only positions after the search root count, ply plies ago at most.
+bool repetition_upcoming(const uint64_t *keys, int32_t count, int32_t window, BitBoard occupied, int32_t ply);
+
+// Earlier occurrences of the board's position, walking its states back through the halfmove clock window.
+// Game draws at two, a threefold repetition.
+int32_t board_repetition_count(const Board &board);
+
+// Keys of the positions before the board's current one within its halfmove clock window, at most max of them, oldest
+// first. Search puts them in front of its own line so a Position search still sees the repetitions of the game.
+int32_t board_key_history(const Board &board, uint64_t *keys, int32_t max);
+} // namespace game
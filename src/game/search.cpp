@@ -0,0 +1,350 @@
+#include "search.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include "eval.hpp"
+#include "movepicker.hpp"
+#include "position.hpp"
+#include "repetition.hpp"
+#include "vector.hpp"
+
+namespace game {
+static constexpr int32_t ASPIRATION_WINDOW = 25;  // Half width of the first window, doubled on every fail
+static constexpr int32_t ASPIRATION_MIN_DEPTH = 4; // Shallower iterations are too unstable to guess from
+static constexpr uint64_t SEARCH_CHECK_INTERVAL = 1024; // Nodes between two looks at the clock, well under a millisecond
+static constexpr int32_t DELTA_MARGIN = 200;              // Most a capture is taken to bring on top of the material it wins
+
+// What the threads of one search have in common besides the transposition table
+struct SearchShared {
+    std::atomic<bool> stop{false};         // Raised by the main thread, every thread polls it at each node
+    std::atomic<uint64_t> helper_nodes{0}; // Published by the helpers every SEARCH_CHECK_INTERVAL nodes, for the node limit
+};
+
+// Everything one thread works on, allocated once per search so the node loop never allocates
+struct SearchThread {
+    PositionStack stack; // Copy-made positions of the current line, stack.positions[ply] is the node at that ply
+    TranspositionTable *tt{nullptr};
+    SearchShared *shared{nullptr};
+    int32_t index{0}; // 0 is the main thread, it alone keeps the limits and the result
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point start;
+    uint64_t nodes{0};
+    uint64_t published_nodes{0};
+    bool stopped{false};
+    gtr::array<gtr::array<Move, SEARCH_MAX_PLY>, SEARCH_MAX_PLY> pv; // pv[ply] is the best line found from that ply
+    gtr::array<int32_t, SEARCH_MAX_PLY> pv_length;
+    gtr::array<Move, SEARCH_MAX_PLY> previous_pv; // Line of the last finished iteration, tried first along the way
+    // Keys of the game before the root, oldest first, then of the current line: keys[game_keys + ply] is the node at that ply
+    gtr::array<uint64_t, FIFTY_MOVE_RULE_PLIES + SEARCH_MAX_PLY> keys;
+    int32_t game_keys{0};
+    MoveOrdering ordering; // Killers, history and countermoves of this thread only
+};
+static_assert(SEARCH_MAX_PLY <= MoveOrdering::MAX_PLY);
+static_assert(SEARCH_MAX_PLY <= PositionStack::MAX_PLY);
+
+static double search_seconds_since(const std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool search_should_stop(SearchThread &thread) {
+    SearchShared &shared = *thread.shared;
+    if (shared.stop.load(std::memory_order_relaxed)) {
+        thread.stopped = true;
+    } else if (thread.index != 0) {
+        if (thread.nodes % SEARCH_CHECK_INTERVAL == 0) {
+            shared.helper_nodes.fetch_add(thread.nodes - thread.published_nodes, std::memory_order_relaxed);
+            thread.published_nodes = thread.nodes;
+        }
+    } else if (thread.limits.stop != nullptr && thread.limits.stop->load(std::memory_order_relaxed)) {
+        thread.stopped = true;
+    } else if (thread.limits.nodes != 0 && thread.nodes + shared.helper_nodes.load(std::memory_order_relaxed) >= thread.limits.nodes) {
+        thread.stopped = true;
+    } else if (thread.limits.time_ms != 0 && thread.nodes % SEARCH_CHECK_INTERVAL == 0) {
+        thread.stopped = search_seconds_since(thread.start) * 1000.0 >= static_cast<double>(thread.limits.time_ms);
+    }
+    if (thread.stopped && thread.index == 0) {
+        shared.stop.store(true, std::memory_order_relaxed);
+    }
+    return thread.stopped;
+}
+
+static void search_update_pv(SearchThread &thread, const int32_t ply, const Move move) {
+    thread.pv[ply][0] = move;
+    const int32_t child_length = ply + 1 < SEARCH_MAX_PLY ? thread.pv_length[ply + 1] : 0;
+    std::copy_n(thread.pv[ply + 1].begin(), child_length, thread.pv[ply].begin() + 1);
+    thread.pv_length[ply] = child_length + 1;
+}
+
+// Mate scores are stored relative to the node, not the root, so a hit found at another ply still counts the plies right
+static int32_t search_score_to_tt(const int32_t score, const int32_t ply) {
+    return score >= SCORE_MATE_BOUND ? score + ply : score <= -SCORE_MATE_BOUND ? score - ply : score;
+}
+
+static int32_t search_score_from_tt(const int32_t score, const int32_t ply) {
+    return score >= SCORE_MATE_BOUND ? score - ply : score <= -SCORE_MATE_BOUND ? score + ply : score;
+}
+
+static int32_t search_evaluate(const Position &pos) { return eval_score(pos.eval, pos.side_to_move); }
+
+/*
+ Quiescence search below the horizon: only captures and promotions, until the position is quiet enough to trust the
+ static evaluation. The side to move may stand pat on the evaluation, a quiet move would usually do at least as well,
+ so it is a lower bound that can cut off right away. Captures that could not reach alpha even with DELTA_MARGIN and
+ captures losing material by static exchange are skipped. In check every evasion is searched and nothing is skipped.
+*/
+static int32_t search_quiescence(SearchThread &thread, int32_t alpha, const int32_t beta, const int32_t ply) {
+    const Position &pos = thread.stack.current();
+    thread.pv_length[ply] = 0;
+    if (ply >= SEARCH_MAX_PLY - 1) {
+        return search_evaluate(pos);
+    }
+    if (search_should_stop(thread)) {
+        return 0;
+    }
+    ++thread.nodes;
+
+    const bool in_check = position_checkers(pos) != 0;
+    int32_t stand_pat = -SCORE_INFINITE;
+    if (!in_check) {
+        stand_pat = search_evaluate(pos);
+        if (stand_pat >= beta) {
+            return stand_pat;
+        }
+        alpha = std::max(alpha, stand_pat);
+    }
+
+    MovePicker picker(pos, in_check ? GEN_ALL : GEN_CAPTURES);
+    int32_t best = stand_pat;
+    Move move;
+    while (picker.next(move)) {
+        if (!in_check) {
+            const PieceType victim = move.is_en_passant() ? PAWN : PIECE_TYPE(position_piece_on(pos, move.get_destination_index()));
+            if (!move.is_promotion() && stand_pat + SEE_VALUE[victim] + DELTA_MARGIN <= alpha) {
+                continue;
+            }
+            if (!move_picker_see_ge(pos, move, 0)) {
+                continue;
+            }
+        }
+        thread.stack.make<EVAL_INCREMENTAL>(move);
+        const int32_t score = -search_quiescence(thread, -beta, -alpha, ply + 1);
+        thread.stack.unmake();
+        if (thread.stopped) {
+            return 0;
+        }
+        if (score > best) {
+            best = score;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+    }
+
+    // Every evasion was searched, none means mate
+    if (in_check && best == -SCORE_INFINITE) {
+        return -SCORE_MATE + ply;
+    }
+    return best;
+}
+
+static int32_t search_pvs(SearchThread &thread, const int32_t depth, int32_t alpha, const int32_t beta, const int32_t ply, const bool pv_node) {
+    const Position &pos = thread.stack.current();
+    thread.pv_length[ply] = 0;
+    if (ply >= SEARCH_MAX_PLY - 1) {
+        return search_evaluate(pos);
+    }
+    // Only the root may sit on a repeated or fifty-move position, the game is not over there yet.
+    // Checked before the horizon so the move back into a repetition scores the draw even with no depth left
+    const int32_t key_count = thread.game_keys + ply + 1;
+    thread.keys[key_count - 1] = pos.key;
+    if (ply > 0 && (pos.halfmove_clock >= FIFTY_MOVE_RULE_PLIES || repetition_count(thread.keys.data(), key_count, pos.halfmove_clock) > 0)) {
+        return SCORE_DRAW;
+    }
+
+    // A move going back to a position of the search is a draw the side to move can always play, one ply before it happens
+    const bool draw_upcoming = ply > 0 && alpha < SCORE_DRAW && repetition_upcoming(thread.keys.data(), key_count, pos.halfmove_clock, pos.pieces_by_type[ANY], ply);
+    if (draw_upcoming) {
+        alpha = SCORE_DRAW;
+        if (alpha >= beta) {
+            return alpha;
+        }
+    }
+    if (depth <= 0) {
+        // The quiescence search does not try the quiet move back, the draw is still there to take
+        const int32_t score = search_quiescence(thread, alpha, beta, ply);
+        return draw_upcoming && !thread.stopped ? std::max(score, SCORE_DRAW) : score;
+    }
+    if (search_should_stop(thread)) {
+        return 0;
+    }
+    ++thread.nodes;
+
+    // Bounds only cut outside the principal variation, there the exact line is wanted
+    const uint64_t key = pos.key;
+    TTData tt_entry{};
+    const bool tt_hit = thread.tt->probe(key, tt_entry);
+    if (tt_hit && !pv_node && tt_entry.depth >= depth) {
+        const int32_t tt_score = search_score_from_tt(tt_entry.score, ply);
+        if (tt_entry.bound == TT_BOUND_EXACT || (tt_entry.bound == TT_BOUND_LOWER && tt_score >= beta) || (tt_entry.bound == TT_BOUND_UPPER && tt_score <= alpha)) {
+            return tt_score;
+        }
+    }
+
+    const int32_t original_alpha = alpha;
+    MovePicker picker(pos, tt_hit && tt_entry.move != Move{} ? tt_entry.move : thread.previous_pv[ply], thread.ordering, ply);
+    gtr::array<Move, MoveList::MAX_MOVES> quiets; // Quiet moves searched so far, their history drops when a later one cuts off
+    int32_t quiet_count = 0;
+    Move best_move{};
+    int32_t best = -SCORE_INFINITE;
+    int32_t searched = 0;
+    Move move;
+    while (picker.next(move)) {
+        const bool quiet = move_picker_is_quiet(pos, move);
+        thread.stack.make<EVAL_INCREMENTAL>(move);
+        thread.tt->prefetch(thread.stack.current().key);
+        int32_t score = 0;
+        if (searched++ == 0) {
+            score = -search_pvs(thread, depth - 1, -beta, -alpha, ply + 1, pv_node);
+        } else {
+            // Later moves only have to be proven worse than the first, the full window is reopened when one is not
+            score = -search_pvs(thread, depth - 1, -alpha - 1, -alpha, ply + 1, false);
+            if (score > alpha && score < beta) {
+                score = -search_pvs(thread, depth - 1, -beta, -alpha, ply + 1, true);
+            }
+        }
+        thread.stack.unmake();
+        if (thread.stopped) {
+            return 0;
+        }
+        if (score > best) {
+            best = score;
+            if (score > alpha) {
+                alpha = score;
+                best_move = move;
+                search_update_pv(thread, ply, move);
+                if (alpha >= beta) {
+                    if (quiet) {
+                        move_ordering_update(thread.ordering, pos.side_to_move, ply, depth, pos.last_move, move, quiets.data(), quiet_count);
+                    }
+                    break;
+                }
+            }
+        }
+        if (quiet) {
+            quiets[quiet_count++] = move;
+        }
+    }
+
+    if (searched == 0) {
+        return position_checkers(pos) ? -SCORE_MATE + ply : SCORE_DRAW;
+    }
+    const TTBound bound = best >= beta ? TT_BOUND_LOWER : best > original_alpha ? TT_BOUND_EXACT : TT_BOUND_UPPER;
+    thread.tt->store(key, best_move, search_score_to_tt(best, ply), depth, bound);
+    return best;
+}
+
+// Searches the root inside a window around the previous score, widening the failing side until the score lands inside
+static int32_t search_aspiration(SearchThread &thread, const int32_t depth, const int32_t previous_score) {
+    int32_t window = ASPIRATION_WINDOW;
+    int32_t alpha = -SCORE_INFINITE;
+    int32_t beta = SCORE_INFINITE;
+    if (depth >= ASPIRATION_MIN_DEPTH && std::abs(previous_score) < SCORE_MATE_BOUND) {
+        alpha = std::max(previous_score - window, -SCORE_INFINITE);
+        beta = std::min(previous_score + window, SCORE_INFINITE);
+    }
+    while (true) {
+        const int32_t score = search_pvs(thread, depth, alpha, beta, 0, true);
+        if (thread.stopped) {
+            return score;
+        }
+        window *= 2;
+        if (score <= alpha) {
+            alpha = std::max(score - window, -SCORE_INFINITE);
+        } else if (score >= beta) {
+            beta = std::min(score + window, SCORE_INFINITE);
+        } else {
+            return score;
+        }
+    }
+}
+
+/*
+ Iterative deepening for one thread. Helpers run the same loop on their own positions and only meet the others through the
+ transposition table, the odd ones one ply ahead so the threads spread over two depths and fill the table for each other.
+*/
+static void search_iterate(SearchThread &thread, SearchResult &result) {
+    const int32_t max_depth = std::clamp(thread.limits.depth, 1, SEARCH_MAX_PLY - 1);
+    for (int32_t depth = 1 + thread.index % 2; depth <= max_depth; ++depth) {
+        const int32_t score = search_aspiration(thread, depth, result.score);
+        if (thread.stopped) {
+            break; // A cut short iteration only saw part of the tree, the previous one stands
+        }
+        result.score = score;
+        result.depth = depth;
+        result.pv_length = thread.pv_length[0];
+        std::copy_n(thread.pv[0].begin(), result.pv_length, result.pv.begin());
+        std::copy_n(thread.pv[0].begin(), result.pv_length, thread.previous_pv.begin());
+        if (result.pv_length > 0) {
+            result.best_move = result.pv[0];
+        }
+        if (std::abs(score) >= SCORE_MATE_BOUND) {
+            break; // A forced mate does not get any shorter with more depth
+        }
+    }
+}
+
+SearchResult search(const Board &board, const SearchLimits &limits, TranspositionTable &tt) {
+    SearchResult result{};
+    const Position root = position_from_board(board); // Computes the evaluation terms, game moves do not keep them
+    MoveList root_moves;
+    generate_legal_moves(root, root_moves);
+    if (root_moves.empty()) {
+        return result;
+    }
+    result.best_move = root_moves[0]; // Something legal to play even if the first iteration is cut short
+    gtr::array<uint64_t, FIFTY_MOVE_RULE_PLIES> game_keys;
+    const int32_t game_key_count = board_key_history(board, game_keys.data(), FIFTY_MOVE_RULE_PLIES);
+
+    tt.new_search();
+    SearchShared shared;
+    const int32_t thread_count = std::max(limits.threads, 1);
+    const auto threads = std::make_unique<SearchThread[]>(static_cast<size_t>(thread_count));
+    const auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < thread_count; ++i) {
+        SearchThread &thread = threads[i];
+        thread.stack.reset(root);
+        std::copy_n(game_keys.begin(), game_key_count, thread.keys.begin());
+        thread.game_keys = game_key_count;
+        thread.tt = &tt;
+        thread.shared = &shared;
+        thread.index = i;
+        thread.limits = limits;
+        thread.start = start;
+        std::fill(thread.previous_pv.begin(), thread.previous_pv.end(), Move{});
+        thread.ordering.clear();
+    }
+
+    // The helpers' results are thrown away, the main thread decides the move and when everyone stops
+    gtr::vector<std::thread> helpers;
+    for (int32_t i = 1; i < thread_count; ++i) {
+        helpers.emplace_back([&threads, i] {
+            SearchResult helper_result{};
+            search_iterate(threads[i], helper_result);
+        });
+    }
+    search_iterate(threads[0], result);
+    shared.stop.store(true, std::memory_order_relaxed);
+    for (auto &helper : helpers) { helper.join(); }
+
+    result.nodes = 0;
+    for (int32_t i = 0; i < thread_count; ++i) { result.nodes += threads[i].nodes; }
+    result.seconds = search_seconds_since(start);
+    return result;
+}
+} // namespace game
@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include "array.hpp"
+#include "board.hpp"
+#include "move.hpp"
+#include "transposition.hpp"
+
+namespace game {
+constexpr int32_t SEARCH_MAX_PLY = 128;
+constexpr int32_t SCORE_INFINITE = 32001;
+constexpr int32_t SCORE_MATE = 32000;                          // Mated at the root, a mate found n plies deep scores SCORE_MATE - n
+constexpr int32_t SCORE_MATE_BOUND = SCORE_MATE - SEARCH_MAX_PLY; // Scores past this bound are mates
+constexpr int32_t SCORE_DRAW = 0;
+
+// A zero means no limit. A search stopped before depth 1 finishes still returns a legal move, not a searched one
+struct SearchLimits {
+    int32_t depth{SEARCH_MAX_PLY - 1};
+    uint64_t nodes{0}; // Summed over every thread
+    uint64_t time_ms{0};
+    int32_t threads{1};
+    const std::atomic<bool> *stop{nullptr}; // Raised by the caller, from any thread, to end the search as if a limit was hit
+};
+
+// The last iteration that finished, scores are from the side to move's point of view
+struct SearchResult {
+    Move best_move{};
+    int32_t score{0};
+    int32_t depth{0};
+    uint64_t nodes{0};
+    double seconds{0};
+    gtr::array<Move, SEARCH_MAX_PLY> pv{};
+    int32_t pv_length{0};
+
+    uint64_t nps() const { return seconds > 0 ? static_cast<uint64_t>(static_cast<double>(nodes) / seconds) : 0; }
+};
+
+/*
+ Iterative deepening principal variation search. Each iteration searches the root with an aspiration window around the
+ previous score and widens it on a fail, the first move of every node gets the full window and the others a null window
+ that is only reopened when they beat alpha. The leaves are resolved by a quiescence search over captures and promotions.
+ Every thread copy-makes Position on its own PositionStack, so the caller's board is left alone. The keys of the game
+ within the halfmove clock window go in front of the thread's line, so repetitions of the game played so far are still seen.
+ Bounds and best moves go to the transposition table, which can be kept from one search to the next.
+ With more than one thread the search is Lazy SMP: every helper searches the same root on its own positions and
+ shares nothing but the table, the calling thread keeps the clock, the limits and the result.
+*/
+SearchResult search(const Board &board, const SearchLimits &limits, TranspositionTable &tt);
+} // namespace game
@@ -0,0 +1,45 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include "../board.hpp"
+#include "../eval.hpp"
+#include "../fen.hpp"
+#include "../movegen.hpp"
+#include "../position.hpp"
+#include "test_util.hpp"
+
+using namespace game;
+
+static void eval_expect_eq(const EvalState &a, const EvalState &b) {
+    EXPECT_EQ(a.middlegame, b.middlegame);
+    EXPECT_EQ(a.endgame, b.endgame);
+    EXPECT_EQ(a.phase, b.phase);
+}
+
+TEST(Eval, IncrementalTerms_MatchRecomputation) {
+    static PositionStack stack;
+    for (const auto *fen : TEST_FENS) {
+        Board board = board_from_fen(fen);
+        // Both representations, the incremental terms against a full recomputation after every move
+        test_walk_lockstep<EVAL_INCREMENTAL>(board, 3, stack, [](const Board &node, const Position &pos) {
+            eval_expect_eq(node.current_state->eval, eval_compute(node));
+            eval_expect_eq(pos.eval, eval_compute(pos));
+        });
+    }
+}
+
+TEST(Eval, Score_SymmetricAndPhased) {
+    // The start position is symmetric and has every piece
+    const Board start;
+    EXPECT_EQ(start.current_state->eval.phase, EVAL_PHASE_MAX);
+    EXPECT_EQ(eval_score(start.current_state->eval, PIECE_WHITE), 0);
+
+    // A rook up, seen from both sides
+    const Board board = board_from_fen("4k3/8/8/8/8/8/8/R3K3 w - - 0 1");
+    const int32_t score = eval_score(board.current_state->eval, PIECE_WHITE);
+    EXPECT_GT(score, 400);
+    EXPECT_EQ(eval_score(board.current_state->eval, PIECE_BLACK), -score);
+    // A lone rook leaves the phase at 2, the score is mostly the endgame terms
+    const EvalState &eval = board.current_state->eval;
+    EXPECT_EQ(eval.phase, 2);
+    EXPECT_EQ(score, (eval.middlegame * 2 + eval.endgame * (EVAL_PHASE_MAX - 2)) / EVAL_PHASE_MAX);
+}
@@ -0,0 +1,154 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include "../game.hpp"
+#include "../movegen.hpp"
+#include "../repetition.hpp"
+
+using namespace game;
+
+// Plays a deterministic game, recording the fen after every ply
+static gtr::vector<Fen> game_play(Game &game, const int32_t plies) {
+    gtr::vector<Fen> fens;
+    fens.push_back(game.board.get_fen());
+    MoveList list;
+    for (int32_t ply = 0; ply < plies; ++ply) {
+        generate_legal_moves(game.board, list);
+        if (list.empty() || !game.move(list[(ply * 7 + 3) % list.size()])) {
+            break;
+        }
+        fens.push_back(game.board.get_fen());
+    }
+    return fens;
+}
+
+TEST(Game, Seek_MatchesPlayedPositions) {
+    Game game;
+    const auto fens = game_play(game, 120);
+    ASSERT_EQ(game.last_ply() + 1, fens.size());
+
+    static constexpr uint64_t TARGETS[] = {0, 5, 16, 17, 100, 3, 64, 63, 1, 119, 33};
+    for (const auto target : TARGETS) {
+        if (target > game.last_ply()) {
+            continue;
+        }
+        ASSERT_TRUE(game.seek(target));
+        EXPECT_EQ(game.current_ply(), target);
+        EXPECT_STREQ(game.board.get_fen().c_str(), fens[target].c_str()) << "ply " << target;
+        EXPECT_EQ(game.board.current_state->key, zobrist_compute(game.board)) << "ply " << target;
+    }
+    EXPECT_FALSE(game.seek(game.last_ply() + 1));
+
+    game.return_first_move();
+    EXPECT_STREQ(game.board.get_fen().c_str(), fens[0].c_str());
+    game.return_last_move();
+    EXPECT_STREQ(game.board.get_fen().c_str(), fens[fens.size() - 1].c_str());
+}
+
+TEST(Game, Seek_AfterRewritingTheTimeline) {
+    Game game;
+    game_play(game, 40);
+    ASSERT_TRUE(game.seek(20));
+
+    // A different move at ply 20 drops the old future and its checkpoints
+    MoveList list;
+    generate_legal_moves(game.board, list);
+    ASSERT_TRUE(game.move(list[0]));
+    const auto fens = game_play(game, 30);
+    EXPECT_EQ(game.last_ply(), 21 + fens.size() - 1);
+
+    ASSERT_TRUE(game.seek(21));
+    EXPECT_STREQ(game.board.get_fen().c_str(), fens[0].c_str());
+    ASSERT_TRUE(game.seek(game.last_ply()));
+    EXPECT_STREQ(game.board.get_fen().c_str(), fens[fens.size() - 1].c_str());
+}
+
+TEST(Game, TerminalState_SideToMove) {
+    using enum Game::GameStatus;
+    Game game;
+    EXPECT_EQ(analyze_terminal_state(game.board), WHITE_TURN);
+    ASSERT_TRUE(game.set_position("rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3"));
+    EXPECT_EQ(game.status, WHITE_CHECKMATE);
+    ASSERT_TRUE(game.set_position("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1"));
+    EXPECT_EQ(game.status, BLACK_STALEMATE);
+    ASSERT_TRUE(game.set_position("8/8/4k3/8/8/3NK3/8/8 w - - 0 1"));
+    EXPECT_EQ(game.status, INSUFFICIENT_MATERIAL);
+    ASSERT_TRUE(game.set_position("4k3/8/8/8/8/8/8/R3K3 b - - 0 1"));
+    EXPECT_EQ(game.status, BLACK_TURN);
+}
+
+TEST(Game, TerminalState_RepetitionAndFiftyMoves) {
+    using enum Game::GameStatus;
+    Game game;
+    static constexpr gtr::array<Move, 4> shuffle = {move_make(G1, F3), move_make(G8, F6), move_make(F3, G1), move_make(F6, G8)};
+    for (int32_t round = 0; round < 2; ++round) {
+        for (const auto move : shuffle) {
+            EXPECT_EQ(game.status, game.board.side_to_move == PIECE_WHITE ? WHITE_TURN : BLACK_TURN) << game.board.get_fen().c_str();
+            ASSERT_TRUE(game.move(move));
+        }
+    }
+    // The start position for the third time
+    EXPECT_EQ(board_repetition_count(game.board), 2);
+    EXPECT_EQ(game.status, THREEFOLD_REPETITION);
+    EXPECT_FALSE(game.move(move_make(E2, E4)));
+    EXPECT_TRUE(game.undo());
+    EXPECT_EQ(game.status, BLACK_TURN);
+
+    // The clock counts reversible plies, get_fen writes it back
+    ASSERT_TRUE(game.set_position("4k3/8/8/8/8/8/4P3/R3K3 w - - 98 60"));
+    ASSERT_TRUE(game.move(move_make(A1, A2)));
+    EXPECT_EQ(game.board.get_fen().halfmove_clock(), 99);
+    ASSERT_TRUE(game.move(move_make(E8, D8)));
+    EXPECT_EQ(game.status, FIFTY_MOVE_RULE);
+    EXPECT_TRUE(game.undo());
+    ASSERT_TRUE(game.move(move_make(E8, E7)));
+    EXPECT_EQ(game.status, FIFTY_MOVE_RULE);
+
+    // A pawn move resets it
+    ASSERT_TRUE(game.set_position("4k3/8/8/8/8/8/4P3/R3K3 w - - 98 60"));
+    ASSERT_TRUE(game.move(move_make(E2, E4)));
+    EXPECT_EQ(game.board.current_state->halfmove_clock, 0);
+}
+
+TEST(Game, UpcomingRepetition_FromKeys) {
+    Board board;
+    gtr::vector<uint64_t> keys;
+    keys.push_back(board.current_state->key);
+    for (const auto move : {move_make(G1, F3), move_make(G8, F6), move_make(F3, G1)}) {
+        board.move(move);
+        keys.push_back(board.current_state->key);
+    }
+    // Black can play Nf6-g8 back to the start position
+    EXPECT_TRUE(repetition_upcoming(keys.data, static_cast<int32_t>(keys.size()), board.current_state->halfmove_clock, board.pieces_by_type[ANY], 4));
+    // Only when the start position is inside the search
+    EXPECT_FALSE(repetition_upcoming(keys.data, static_cast<int32_t>(keys.size()), board.current_state->halfmove_clock, board.pieces_by_type[ANY], 3));
+    EXPECT_EQ(repetition_count(keys.data, static_cast<int32_t>(keys.size()), board.current_state->halfmove_clock), 0);
+
+    board.move(move_make(F6, G8));
+    keys.push_back(board.current_state->key);
+    EXPECT_EQ(repetition_count(keys.data, static_cast<int32_t>(keys.size()), board.current_state->halfmove_clock), 1);
+    EXPECT_EQ(board_repetition_count(board), 1);
+}
+
+TEST(Game, BoardVersion_ChangesWithThePosition) {
+    Game game;
+    uint64_t version = game.board.version;
+    EXPECT_TRUE(game.move(move_make(E2, E4)));
+    EXPECT_NE(game.board.version, version);
+
+    // Stateless pairs leave the position, and so the version, where they found it
+    version = game.board.version;
+    BoardState state{};
+    game.board.move_stateless(move_make(E7, E5), state);
+    game.board.undo_stateless(state);
+    EXPECT_EQ(game.board.version, version);
+
+    EXPECT_TRUE(game.undo());
+    EXPECT_NE(game.board.version, version);
+    version = game.board.version;
+    game.seek(1);
+    EXPECT_NE(game.board.version, version);
+
+    // A copy never looks like a version either board already had
+    const Board copy = game.board;
+    EXPECT_GT(copy.version, game.board.version);
+}
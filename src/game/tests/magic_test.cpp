@@ -0,0 +1,49 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include "../bitboard.hpp"
+#include "../random.hpp"
+
+using namespace game;
+
+// The generated MAGIC_BOARD must answer exactly like tables built at runtime
+TEST(Magic, GeneratedTables_MatchRuntimeInit) {
+    static const MagicBoards runtime = detail::init_magic_boards();
+    detail::RandomGenerator rng;
+    for (int32_t sq = A1; sq < SQUARE_COUNT; ++sq) {
+        const auto square = static_cast<SquareIndex>(sq);
+        EXPECT_EQ(MAGIC_BOARD.knight_attacks[sq], runtime.knight_attacks[sq]);
+        EXPECT_EQ(MAGIC_BOARD.king_attacks[sq], runtime.king_attacks[sq]);
+        for (int32_t i = 0; i < 256; ++i) {
+            const BitBoard occ = rng.sparse_rand() | rng.sparse_rand();
+            EXPECT_EQ(MAGIC_BOARD.slider_attacks<ROOK>(occ, square), runtime.slider_attacks<ROOK>(occ, square));
+            EXPECT_EQ(MAGIC_BOARD.slider_attacks<BISHOP>(occ, square), runtime.slider_attacks<BISHOP>(occ, square));
+        }
+    }
+}
+
+TEST(Magic, PextBackend_MatchesMagic) {
+    if (!cpu_has_fast_pext()) {
+        GTEST_SKIP() << "No fast BMI2 on this CPU";
+    }
+    detail::RandomGenerator rng;
+    for (int32_t sq = A1; sq < SQUARE_COUNT; ++sq) {
+        const auto square = static_cast<SquareIndex>(sq);
+        for (int32_t i = 0; i < 256; ++i) {
+            const BitBoard occ = rng.sparse_rand() | rng.sparse_rand();
+            EXPECT_EQ((MAGIC_BOARD.slider_attacks<ROOK, SLIDER_PEXT>(occ, square)), MAGIC_BOARD.slider_attacks<ROOK>(occ, square));
+            EXPECT_EQ((MAGIC_BOARD.slider_attacks<BISHOP, SLIDER_PEXT>(occ, square)), MAGIC_BOARD.slider_attacks<BISHOP>(occ, square));
+        }
+    }
+}
+
+TEST(Magic, DirectLayout_MatchesCompressed) {
+    detail::RandomGenerator rng;
+    for (int32_t sq = A1; sq < SQUARE_COUNT; ++sq) {
+        const auto square = static_cast<SquareIndex>(sq);
+        for (int32_t i = 0; i < 256; ++i) {
+            const BitBoard occ = rng.sparse_rand() | rng.sparse_rand();
+            EXPECT_EQ((MAGIC_BOARD.slider_attacks<ROOK, SLIDER_MAGIC_DIRECT>(occ, square)), MAGIC_BOARD.slider_attacks<ROOK>(occ, square));
+            EXPECT_EQ((MAGIC_BOARD.slider_attacks<BISHOP, SLIDER_MAGIC_DIRECT>(occ, square)), MAGIC_BOARD.slider_attacks<BISHOP>(occ, square));
+        }
+    }
+}
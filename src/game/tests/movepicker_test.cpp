@@ -0,0 +1,157 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include "../board.hpp"
+#include "../fen.hpp"
+#include "../movegen.hpp"
+#include "../movepicker.hpp"
+#include "test_util.hpp"
+
+using namespace game;
+
+// Every 16 bit value is checked, so hash and killer moves from unrelated positions are covered
+static void picker_check_legality(const Board &board) {
+    MoveList list;
+    generate_legal_moves(board, list);
+    for (uint32_t bits = 0; bits <= UINT16_MAX; ++bits) {
+        const Move move{static_cast<Move::storage_type>(bits)};
+        ASSERT_EQ(is_legal_move(board, move), list.contains(move)) << board.get_fen().c_str() << " " << move_to_uci(move).c_str();
+    }
+}
+
+TEST(MovePicker, IsLegalMove_MatchesGenerator) {
+    for (const auto *fen : TEST_FENS) {
+        Board board = board_from_fen(fen);
+        test_walk(board, 1, picker_check_legality);
+    }
+}
+
+TEST(MovePicker, YieldsEveryLegalMoveOnce) {
+    for (const auto *fen : TEST_FENS) {
+        const Board board = board_from_fen(fen);
+        MoveList legal;
+        generate_legal_moves(board, legal);
+        MoveList captures;
+        generate_legal_moves(board, captures, GEN_CAPTURES);
+
+        // A quiet hash move, a capture and an illegal move as killers
+        const Move tt_move = legal[legal.size() - 1];
+        const Move killer_capture = captures.empty() ? Move{} : captures[0];
+        MovePicker picker(board, tt_move, killer_capture, move_make(A1, H8));
+
+        MoveList picked;
+        Move move{};
+        int32_t last_capture_score = INT32_MAX;
+        while (picker.next(move)) {
+            ASSERT_FALSE(picked.contains(move)) << fen << " " << move_to_uci(move).c_str();
+            ASSERT_TRUE(legal.contains(move)) << fen << " " << move_to_uci(move).c_str();
+            if (picked.empty()) {
+                EXPECT_EQ(move, tt_move);
+            } else if (picker.stage == MovePicker<Board>::STAGE_CAPTURES) {
+                const int32_t score = move_picker_mvv_lva(board, move);
+                EXPECT_LE(score, last_capture_score);
+                last_capture_score = score;
+            }
+            picked.push(move);
+        }
+        EXPECT_EQ(picked.size(), legal.size()) << fen;
+    }
+}
+
+TEST(MovePicker, OrderingTables) {
+    const Board board = board_from_fen(TEST_FENS[1]);
+    MoveList legal;
+    generate_legal_moves(board, legal);
+    MoveList quiets;
+    generate_legal_moves(board, quiets, GEN_QUIETS);
+    ASSERT_GE(quiets.size(), 4);
+
+    // Cutoffs by two quiet moves at ply 3 after the same previous move, the first one failed again later on
+    MoveOrdering ordering{};
+    ordering.clear();
+    const Move previous = move_make(E7, E6);
+    move_ordering_update(ordering, board.side_to_move, 3, 6, previous, quiets[0], &quiets[2], 2);
+    move_ordering_update(ordering, board.side_to_move, 3, 4, Move{}, quiets[1], &quiets[0], 1);
+    EXPECT_EQ(ordering.killers[3][0], quiets[1]);
+    EXPECT_EQ(ordering.killers[3][1], quiets[0]);
+    EXPECT_EQ(ordering.countermoves[previous.get_origin()][previous.get_destination()], quiets[0]);
+    const auto &history = ordering.history[board.side_to_move];
+    EXPECT_GT(history[quiets[1].get_origin()][quiets[1].get_destination()], 0);
+    EXPECT_LT(history[quiets[2].get_origin()][quiets[2].get_destination()], 0);
+
+    // Gravity keeps repeated bonuses below the cap
+    for (int32_t i = 0; i < 1000; ++i) { move_ordering_update(ordering, board.side_to_move, 0, 20, Move{}, quiets[3], nullptr, 0); }
+    EXPECT_LE(history[quiets[3].get_origin()][quiets[3].get_destination()], HISTORY_MAX);
+
+    // Killers come right after the captures, then the quiet moves by decreasing history, each legal move once
+    MovePicker picker(board, Move{}, ordering, 3);
+    MoveList picked;
+    Move move{};
+    int32_t last_history = INT32_MAX;
+    while (picker.next(move)) {
+        ASSERT_FALSE(picked.contains(move)) << move_to_uci(move).c_str();
+        if (picker.stage == MovePicker<Board>::STAGE_KILLERS) {
+            EXPECT_TRUE(move == quiets[1] || move == quiets[0]);
+        } else if (picker.stage == MovePicker<Board>::STAGE_QUIETS) {
+            const int32_t score = history[move.get_origin()][move.get_destination()];
+            EXPECT_LE(score, last_history);
+            last_history = score;
+        }
+        picked.push(move);
+    }
+    EXPECT_EQ(picked.size(), legal.size());
+}
+
+static Move picker_find_move(const Board &board, const SquareIndex from, const SquareIndex to) {
+    MoveList list;
+    generate_legal_moves(board, list);
+    for (const Move move : list) {
+        if (move.get_origin() == from && move.get_destination() == to && (!move.is_promotion() || move.get_promotion_piece_type() == QUEEN)) {
+            return move;
+        }
+    }
+    ADD_FAILURE() << "move not found";
+    return Move{};
+}
+
+TEST(MovePicker, StaticExchange) {
+    // The queen takes a pawn the c6 pawn defends, the rook in front of it loses less since the queen backs it up
+    const Board defended = board_from_fen("4k3/8/2p5/3p4/8/8/8/3QK3 w - - 0 1");
+    const Move queen_takes = picker_find_move(defended, D1, D5);
+    EXPECT_FALSE(move_picker_see_ge(defended, queen_takes, 0));
+    EXPECT_TRUE(move_picker_see_ge(defended, queen_takes, -800));
+    EXPECT_FALSE(move_picker_see_ge(defended, queen_takes, -799));
+
+    const Board x_ray = board_from_fen("4k3/8/2p5/3p4/8/8/3R4/3QK3 w - - 0 1");
+    const Move rook_takes = picker_find_move(x_ray, D2, D5);
+    EXPECT_TRUE(move_picker_see_ge(x_ray, rook_takes, -300));
+    EXPECT_FALSE(move_picker_see_ge(x_ray, rook_takes, -299));
+
+    // En passant trades pawns, a free promotion wins the queen less the pawn
+    const Board en_passant = board_from_fen(TEST_FENS[5]);
+    const Move takes_en_passant = picker_find_move(en_passant, E5, F6);
+    EXPECT_TRUE(move_picker_see_ge(en_passant, takes_en_passant, 0));
+    EXPECT_FALSE(move_picker_see_ge(en_passant, takes_en_passant, 1));
+
+    const Board promotion = board_from_fen("8/1P6/8/8/8/8/k7/4K3 w - - 0 1");
+    EXPECT_TRUE(move_picker_see_ge(promotion, picker_find_move(promotion, B7, B8), 800));
+    EXPECT_FALSE(move_picker_see_ge(promotion, picker_find_move(promotion, B7, B8), 801));
+}
+
+TEST(MovePicker, CapturesOnly) {
+    for (const char *fen : TEST_FENS) {
+        const Board board = board_from_fen(fen);
+        MoveList captures;
+        generate_legal_moves(board, captures, GEN_CAPTURES);
+        MovePicker picker(board, GEN_CAPTURES);
+        int32_t count = 0;
+        int32_t previous = INT32_MAX;
+        Move move;
+        while (picker.next(move)) {
+            EXPECT_TRUE(captures.contains(move)) << fen;
+            EXPECT_LE(move_picker_mvv_lva(board, move), previous) << fen;
+            previous = move_picker_mvv_lva(board, move);
+            ++count;
+        }
+        EXPECT_EQ(count, captures.size()) << fen;
+    }
+}
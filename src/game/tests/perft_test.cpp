@@ -0,0 +1,124 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include "../analyzer.hpp"
+#include "../board.hpp"
+#include "../fen.hpp"
+#include "../movegen.hpp"
+#include "../perft.hpp"
+#include "test_util.hpp"
+
+using namespace game;
+
+struct PerftCase {
+    const char *fen;
+    int32_t depth;
+    uint64_t nodes;
+};
+
+// Reference counts from the chessprogramming wiki perft results page
+static constexpr PerftCase PERFT_CASES[] = {
+    {Fen::FEN_START, 1, 20},
+    {Fen::FEN_START, 2, 400},
+    {Fen::FEN_START, 3, 8902},
+    {Fen::FEN_START, 4, 197281},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 1, 48},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 2, 2039},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 4, 43238},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624},
+    {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9467},
+    {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333},
+    {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379},
+    {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 3, 89890},
+};
+
+TEST(Perft, KnownPositions_MatchReferenceCounts) {
+    for (const auto &c : PERFT_CASES) {
+        Board board = board_from_fen(c.fen);
+        EXPECT_EQ(perft(board, c.depth), c.nodes) << c.fen << " depth " << c.depth;
+    }
+}
+
+TEST(Perft, Divide_SumsToTotal_AndRestoresBoard) {
+    Board board = board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    const auto pieces_before = board.pieces;
+    const Fen fen_before = board.get_fen();
+
+    PerftDivide divide;
+    perft_divide(board, 3, divide);
+    uint64_t sum = 0;
+    for (int32_t i = 0; i < divide.moves.size(); ++i) { sum += divide.nodes[i]; }
+    EXPECT_EQ(divide.moves.size(), 48);
+    EXPECT_EQ(sum, divide.total);
+    EXPECT_EQ(divide.total, 97862u);
+
+    for (int32_t i = 0; i < SQUARE_COUNT; ++i) { EXPECT_EQ(board.pieces[i], pieces_before[i]); }
+    EXPECT_STREQ(board.get_fen().c_str(), fen_before.c_str());
+}
+
+TEST(Perft, CountLegalMoves_MatchesGeneratedList) {
+    Board board = board_from_fen("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+    MoveList list;
+    generate_legal_moves(board, list);
+    EXPECT_EQ(count_legal_moves(board), list.size());
+    EXPECT_EQ(list.size(), 6);
+}
+
+TEST(Perft, HasAnyLegalMove_MatchesStatus) {
+    // Fool's mate, a stalemate and an en passant capture that only exists for the side to move
+    Board mate = board_from_fen("rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3");
+    EXPECT_FALSE(has_any_legal_move(mate));
+    EXPECT_TRUE(analyzer_is_color_in_checkmate(&mate, PIECE_WHITE));
+    EXPECT_FALSE(analyzer_get_is_stalemate(&mate, PIECE_WHITE));
+    EXPECT_FALSE(analyzer_is_color_in_checkmate(&mate, PIECE_BLACK));
+
+    Board stalemate = board_from_fen("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1");
+    EXPECT_FALSE(has_any_legal_move(stalemate));
+    EXPECT_TRUE(analyzer_get_is_stalemate(&stalemate, PIECE_BLACK));
+    EXPECT_FALSE(analyzer_is_color_in_checkmate(&stalemate, PIECE_BLACK));
+    EXPECT_EQ(analyzer_get_legal_move_count(&stalemate, PIECE_WHITE), count_legal_moves(board_from_fen("7k/5Q2/6K1/8/8/8/8/8 w - - 0 1")));
+
+    Board en_passant = board_from_fen("8/8/8/2k5/3Pp3/8/8/4K1q1 b - d3 0 1");
+    EXPECT_TRUE(has_any_legal_move(en_passant));
+    EXPECT_EQ(count_legal_moves(en_passant), 1 + count_legal_moves(board_from_fen("8/8/8/2k5/3Pp3/8/8/4K1q1 b - - 0 1")));
+}
+
+// Compares the cached check info with a scan from scratch, and the check squares with making every move
+static void check_info_expect_matches(Board &board) {
+    const Color us = board.side_to_move;
+    const auto king = static_cast<SquareIndex>(lsb(board.get_piece_bitboard(KING, us)));
+    ASSERT_EQ(board.current_state->checkers, attackers_to(board, king, board.pieces_by_type[ANY]) & board.pieces_by_color[~us]) << board.get_fen().c_str();
+    MoveList list;
+    generate_legal_moves(board, list);
+    for (const auto move : list) {
+        BoardState state{};
+        board.move_stateless(move, state);
+        const auto their_king = static_cast<SquareIndex>(lsb(board.get_piece_bitboard(KING, ~us)));
+        const bool in_check = attackers_to(board, their_king, board.pieces_by_type[ANY]) & board.pieces_by_color[us];
+        board.undo_stateless(state);
+        ASSERT_EQ(analyzer_move_puts_to_check(&board, move), in_check) << board.get_fen().c_str() << " " << move_to_uci(move).c_str();
+    }
+}
+
+TEST(Perft, CheckInfo_MatchesScan) {
+    for (const auto *fen : TEST_FENS) {
+        Board board = board_from_fen(fen);
+        test_walk(board, 2, check_info_expect_matches);
+    }
+}
+
+TEST(Perft, Parallel_MatchesSerialDivide) {
+    Board board = board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    PerftDivide serial;
+    perft_divide(board, 4, serial);
+
+    PerftOptions options;
+    options.threads = 4;
+    options.hash_mb = 4;
+    PerftDivide parallel;
+    perft_parallel(board, 4, options, parallel);
+
+    EXPECT_EQ(parallel.total, 4085603u);
+    ASSERT_EQ(parallel.moves.size(), serial.moves.size());
+    for (int32_t i = 0; i < serial.moves.size(); ++i) { EXPECT_EQ(parallel.nodes[i], serial.nodes[i]) << move_to_uci(serial.moves[i]).c_str(); }
+}
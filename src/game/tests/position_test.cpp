@@ -0,0 +1,58 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include "../board.hpp"
+#include "../fen.hpp"
+#include "../movegen.hpp"
+#include "../perft.hpp"
+#include "../position.hpp"
+#include "test_util.hpp"
+
+using namespace game;
+
+// Board make/unmake and Position copy-make in lockstep, everything both of them store must agree after every move
+static void position_expect_matches(const Board &board, const Position &pos) {
+    for (int32_t t = EMPTY; t < PIECE_COUNT_PLUS_ANY; ++t) { ASSERT_EQ(pos.pieces_by_type[t], board.pieces_by_type[t]) << board.get_fen().c_str(); }
+    for (int32_t c = PIECE_WHITE; c < COLOR_COUNT; ++c) { ASSERT_EQ(pos.pieces_by_color[c], board.pieces_by_color[c]) << board.get_fen().c_str(); }
+    ASSERT_EQ(pos.key, board.current_state->key) << board.get_fen().c_str();
+    ASSERT_EQ(pos.castle_rights, board.current_state->castle_rights) << board.get_fen().c_str();
+    ASSERT_EQ(pos.en_passant_index, board.current_state->en_passant_index) << board.get_fen().c_str();
+    ASSERT_EQ(pos.halfmove_clock, board.current_state->halfmove_clock) << board.get_fen().c_str();
+    ASSERT_EQ(pos.side_to_move, board.side_to_move);
+    ASSERT_EQ(count_legal_moves(pos), count_legal_moves(board)) << board.get_fen().c_str();
+}
+
+TEST(Position, CopyMake_MatchesBoard) {
+    static PositionStack stack;
+    for (const auto *fen : TEST_FENS) {
+        Board board = board_from_fen(fen);
+        test_walk_lockstep(board, 3, stack, position_expect_matches);
+    }
+}
+
+TEST(Position, Perft_MatchesReferenceCounts) {
+    EXPECT_EQ(perft(position_from_board(board_from_fen(Fen::FEN_START)), 4), 197281u);
+    EXPECT_EQ(perft(position_from_board(board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1")), 4), 4085603u);
+    EXPECT_EQ(perft(position_from_board(board_from_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1")), 5), 674624u);
+}
+
+TEST(Position, BoardRoundTrip) {
+    Board board = board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    board.move(move_make(E2, A6));
+    board.move(move_make(B4, C3));
+    Board copy;
+    position_to_board(position_from_board(board), copy);
+    EXPECT_STREQ(copy.get_fen().c_str(), board.get_fen().c_str());
+    EXPECT_EQ(copy.current_state->key, board.current_state->key);
+    for (int32_t sq = A1; sq <= H8; ++sq) { EXPECT_EQ(copy.pieces[sq], board.pieces[sq]); }
+}
+
+TEST(Position, HalfmoveClockDoesNotWrap) {
+    Position pos = position_from_board(board_from_fen("4k3/8/8/8/8/8/8/1N2K3 w - - 250 200"));
+    for (int32_t i = 0; i < 5; ++i) {
+        position_make_move(pos, move_make(B1, C3));
+        position_make_move(pos, move_make(E8, D8));
+        position_make_move(pos, move_make(C3, B1));
+        position_make_move(pos, move_make(D8, E8));
+    }
+    EXPECT_EQ(pos.halfmove_clock, 270);
+}
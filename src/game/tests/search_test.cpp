@@ -0,0 +1,163 @@
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <gtest/gtest.h>
+#include "../board.hpp"
+#include "../fen.hpp"
+#include "../game.hpp"
+#include "../movegen.hpp"
+#include "../search.hpp"
+#include "../transposition.hpp"
+#include "test_util.hpp"
+
+using namespace game;
+
+TEST(Search, FindsMates) {
+    TranspositionTable tt{1};
+    // Back rank mate in one, and mate in two with the rooks walking down the board
+    const Board back_rank = board_from_fen("6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1");
+    const SearchResult mate_in_one = search(back_rank, SearchLimits{.depth = 4}, tt);
+    EXPECT_EQ(mate_in_one.best_move.get_destination_index(), A8);
+    EXPECT_EQ(mate_in_one.score, SCORE_MATE - 1);
+
+    const Board ladder = board_from_fen("7k/8/8/8/8/8/R7/1R4K1 w - - 0 1");
+    const SearchResult mate_in_two = search(ladder, SearchLimits{.depth = 6}, tt);
+    EXPECT_EQ(mate_in_two.score, SCORE_MATE - 3);
+    EXPECT_EQ(mate_in_two.pv_length, 3);
+
+    // The side getting mated sees it coming
+    const Board mated = board_from_fen("7k/R7/8/8/8/8/8/1R4K1 b - - 0 1");
+    EXPECT_EQ(search(mated, SearchLimits{.depth = 4}, tt).score, -(SCORE_MATE - 2));
+}
+
+TEST(Search, RespectsLimitsAndLeavesTheBoard) {
+    Board board = board_from_fen(Fen::FEN_START);
+    const uint64_t key = board.current_state->key;
+    const uint64_t version = board.version;
+    TranspositionTable tt{1};
+
+    const SearchResult by_depth = search(board, SearchLimits{.depth = 3}, tt);
+    EXPECT_EQ(by_depth.depth, 3);
+    EXPECT_GT(by_depth.nodes, 0u);
+    EXPECT_TRUE(is_legal_move(board, by_depth.best_move));
+
+    const SearchResult by_nodes = search(board, SearchLimits{.nodes = 2000}, tt);
+    EXPECT_LE(by_nodes.nodes, 2000u);
+    EXPECT_TRUE(is_legal_move(board, by_nodes.best_move));
+
+    EXPECT_EQ(board.current_state->key, key);
+    EXPECT_EQ(board.version, version);
+}
+
+TEST(Search, SearcherPlaysThroughTick) {
+    Game game;
+    game.set_player(PIECE_BLACK, Searcher{.limits = SearchLimits{.depth = 3}});
+    ASSERT_TRUE(game.move(1, 4, 3, 4)); // e2e4
+    // The first tick only starts the search, the frame it runs in is not held up
+    game.tick();
+    EXPECT_EQ(game.current_ply(), 1u);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (game.current_ply() < 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        game.tick();
+    }
+    EXPECT_EQ(game.board.side_to_move, PIECE_WHITE);
+    EXPECT_EQ(game.current_ply(), 2u);
+    EXPECT_EQ(std::get<Searcher>(game.black_player).last_search.depth, 3);
+
+    // Taking the position back while the engine thinks drops that search, the new position gets its own
+    game.set_player(PIECE_WHITE, Searcher{.limits = SearchLimits{.depth = 3}});
+    game.tick();
+    ASSERT_TRUE(game.undo());
+    ASSERT_TRUE(game.undo());
+    while (game.current_ply() < 1 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        game.tick();
+    }
+    EXPECT_EQ(game.current_ply(), 1u);
+    EXPECT_TRUE(is_legal_move(board_from_fen(Fen::FEN_START), game.board.current_state->last_move));
+}
+
+TEST(Search, TranspositionTable_StoreProbeReplace) {
+    TranspositionTable tt{1};
+    const uint64_t key = 0x123456789ABCDEF0ULL;
+    const Move move = move_make(E2, E4);
+    TTData data{};
+    EXPECT_FALSE(tt.probe(key, data));
+
+    tt.store(key, move, -250, 7, TT_BOUND_LOWER);
+    ASSERT_TRUE(tt.probe(key, data));
+    EXPECT_EQ(data.move, move);
+    EXPECT_EQ(data.score, -250);
+    EXPECT_EQ(data.depth, 7);
+    EXPECT_EQ(data.bound, TT_BOUND_LOWER);
+    EXPECT_FALSE(tt.probe(key ^ 1, data)); // Same bucket, other position
+
+    // A much shallower bound from the same search keeps the deeper entry, a fail low keeps the known move
+    tt.store(key, Move{}, 10, 2, TT_BOUND_UPPER);
+    ASSERT_TRUE(tt.probe(key, data));
+    EXPECT_EQ(data.depth, 7);
+    tt.store(key, Move{}, 10, 6, TT_BOUND_UPPER);
+    ASSERT_TRUE(tt.probe(key, data));
+    EXPECT_EQ(data.depth, 6);
+    EXPECT_EQ(data.move, move);
+
+    // A full bucket from an earlier search gives way to the new one before anything else
+    const uint64_t bucket_step = tt.mask + 1;
+    tt.new_search();
+    for (uint64_t i = 1; i <= TT_BUCKET_ENTRIES; ++i) { tt.store(key + i * bucket_step, move, 0, 1, TT_BOUND_EXACT); }
+    EXPECT_FALSE(tt.probe(key, data));
+
+    tt.clear(2);
+    EXPECT_FALSE(tt.probe(key + bucket_step, data));
+}
+
+TEST(Search, LazySmpAgreesOnForcedLines) {
+    TranspositionTable tt{4};
+    const Board ladder = board_from_fen("7k/8/8/8/8/8/R7/1R4K1 w - - 0 1");
+    const SearchResult mate_in_two = search(ladder, SearchLimits{.depth = 6, .threads = 4}, tt);
+    EXPECT_EQ(mate_in_two.score, SCORE_MATE - 3);
+
+    const Board start = board_from_fen(Fen::FEN_START);
+    const SearchResult timed = search(start, SearchLimits{.time_ms = 50, .threads = 3}, tt);
+    EXPECT_GE(timed.depth, 1);
+    EXPECT_LT(timed.seconds, 1.0);
+    EXPECT_TRUE(is_legal_move(start, timed.best_move));
+}
+
+TEST(Search, QuiescenceSeesRecaptures) {
+    TranspositionTable tt{1};
+    // At depth 1 the pawn looks free, the quiescence search sees the queen go back
+    const Board defended = board_from_fen("4k3/8/2p5/3p4/8/8/8/3QK3 w - - 0 1");
+    const SearchResult result = search(defended, SearchLimits{.depth = 1}, tt);
+    EXPECT_NE(result.best_move.get_destination_index(), D5);
+
+    // A hanging queen is taken
+    const Board hanging = board_from_fen("4k3/8/8/3q4/8/8/8/3RK3 w - - 0 1");
+    const SearchResult takes = search(hanging, SearchLimits{.depth = 1}, tt);
+    EXPECT_EQ(takes.best_move.get_destination_index(), D5);
+    EXPECT_GT(takes.score, 0);
+}
+
+TEST(Search, SeesUpcomingRepetition) {
+    TranspositionTable tt{1};
+    // Queen and rook down, but Qh5+ Kg8 Qe8+ Kh7 is a perpetual. At depth 4 only the upcoming repetition sees Qh5 coming back
+    const Board perpetual = board_from_fen("8/6pk/8/8/8/8/q1r5/3Q2K1 w - - 0 1");
+    const SearchResult result = search(perpetual, SearchLimits{.depth = 4}, tt);
+    EXPECT_EQ(result.score, SCORE_DRAW);
+    EXPECT_EQ(result.best_move, move_make(D1, H5));
+}
+
+TEST(Search, SeesRepetitionsOfTheGame) {
+    TranspositionTable tt{1};
+    // Qh5+ Kg8 Qe8+ Kh7 was already played, Qh5+ again repeats a position of the game. Depth 1 cannot see the search's
+    // own repetitions, only the game keys put in front of the line make it a draw
+    Board board = board_from_fen("8/6pk/8/8/8/8/q1r5/3Q2K1 w - - 0 1");
+    board.move(move_make(D1, H5));
+    board.move(move_make(H7, G8));
+    board.move(move_make(H5, E8));
+    board.move(move_make(G8, H7));
+    const SearchResult result = search(board, SearchLimits{.depth = 1}, tt);
+    EXPECT_EQ(result.score, SCORE_DRAW);
+    EXPECT_EQ(result.best_move, move_make(E8, H5));
+}
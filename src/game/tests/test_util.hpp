@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <gtest/gtest.h>
+#include "../board.hpp"
+#include "../fen.hpp"
+#include "../movegen.hpp"
+#include "../position.hpp"
+
+namespace game {
+inline Board board_from_fen(const char *fen_string) {
+    Fen fen;
+    EXPECT_TRUE(fen.set_fen(fen_string));
+    Board board;
+    board.set_position(fen);
+    return board;
+}
+
+// The chessprogramming wiki perft positions, castling, en passant, promotions and pins among them, and an en passant
+// capture that is legal for the side to move. Tests that walk trees from a few positions run over these.
+inline constexpr const char *TEST_FENS[] = {
+    Fen::FEN_START,
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+};
+
+/*
+ Walks every legal line to the given depth with move_stateless / undo_stateless. visit(board) runs at every node, the
+ leaves included, before its children. on_make(move) runs right after a move is made and on_unmake(move) right after it
+ is taken back, so a test can keep a second representation in lockstep. The walk stops at the first failed check.
+*/
+template <EvalPolicy E = EVAL_NONE, typename Visit, typename OnMake, typename OnUnmake>
+void test_walk(Board &board, const int32_t depth, Visit &&visit, OnMake &&on_make, OnUnmake &&on_unmake) {
+    visit(board);
+    if (depth == 0 || ::testing::Test::HasFailure()) {
+        return;
+    }
+    MoveList list;
+    generate_legal_moves(board, list);
+    for (const auto move : list) {
+        BoardState state{};
+        board.move_stateless<E>(move, state);
+        on_make(move);
+        test_walk<E>(board, depth - 1, visit, on_make, on_unmake);
+        board.undo_stateless(state);
+        on_unmake(move);
+        if (::testing::Test::HasFailure()) {
+            return;
+        }
+    }
+}
+
+template <EvalPolicy E = EVAL_NONE, typename Visit> void test_walk(Board &board, const int32_t depth, Visit &&visit) {
+    test_walk<E>(board, depth, visit, [](Move) {}, [](Move) {});
+}
+
+// test_walk with a Position copy-made on the stack alongside the board, visit(board, pos) sees both at every node
+template <EvalPolicy E = EVAL_NONE, typename Visit> void test_walk_lockstep(Board &board, const int32_t depth, PositionStack &stack, Visit &&visit) {
+    stack.reset(position_from_board(board));
+    test_walk<E>(
+        board, depth, [&stack, &visit](const Board &node) { visit(node, stack.current()); }, [&stack](const Move move) { stack.template make<E>(move); },
+        [&stack](Move) { stack.unmake(); });
+}
+} // namespace game
@@ -0,0 +1,55 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include "../board.hpp"
+#include "../fen.hpp"
+#include "../movegen.hpp"
+#include "../zobrist.hpp"
+#include "test_util.hpp"
+
+using namespace game;
+
+TEST(Zobrist, IncrementalKey_MatchesRecomputation) {
+    for (const auto *fen : TEST_FENS) {
+        Board board = board_from_fen(fen);
+        // The incremental key against a full recomputation after every make and unmake
+        const auto check_key = [&board](Move) { ASSERT_EQ(board.current_state->key, zobrist_compute(board)) << board.get_fen().c_str(); };
+        test_walk(board, 3, [](const Board &node) { ASSERT_EQ(node.current_state->key, zobrist_compute(node)) << node.get_fen().c_str(); }, check_key, check_key);
+    }
+}
+
+TEST(Zobrist, Transposition_SameKey) {
+    Board a;
+    Board b;
+    a.move(move_make(G1, F3));
+    a.move(move_make(G8, F6));
+    a.move(move_make(B1, C3));
+    b.move(move_make(B1, C3));
+    b.move(move_make(G8, F6));
+    b.move(move_make(G1, F3));
+    EXPECT_EQ(a.current_state->key, b.current_state->key);
+    EXPECT_EQ(a.current_state->key, zobrist_compute(a));
+
+    // Same pieces with the other side to move
+    Board c = board_from_fen("rnbqkb1r/pppppppp/5n2/8/8/2N2N2/PPPPPPPP/R1BQKB1R w KQkq - 0 1");
+    EXPECT_NE(a.current_state->key, c.current_state->key);
+    EXPECT_EQ(a.current_state->key ^ ZOBRIST.side, c.current_state->key);
+}
+
+TEST(Zobrist, HistoryUndoRedo_RestoresKeys) {
+    Board board;
+    const uint64_t start = board.current_state->key;
+    board.move(move_make(E2, E4));
+    const uint64_t after_e4 = board.current_state->key;
+    board.move(move_make(D7, D5));
+    const uint64_t after_d5 = board.current_state->key;
+
+    EXPECT_TRUE(board.undo());
+    EXPECT_EQ(board.current_state->key, after_e4);
+    EXPECT_TRUE(board.undo());
+    EXPECT_EQ(board.current_state->key, start);
+    EXPECT_TRUE(board.redo());
+    EXPECT_EQ(board.current_state->key, after_e4);
+    EXPECT_TRUE(board.redo());
+    EXPECT_EQ(board.current_state->key, after_d5);
+    EXPECT_EQ(after_d5, zobrist_compute(board));
+}
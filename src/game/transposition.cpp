@@ -0,0 +1,90 @@
+#include "transposition.hpp"
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cstring>
+#include <thread>
+#include "vector.hpp"
+
+namespace game {
+static constexpr int32_t TT_AGE_WEIGHT = 8; // One search of age outweighs this many plies of depth when picking the entry to replace
+
+// move | score << 16 | depth << 32 | bound << 40 | age << 42
+static uint64_t tt_pack(const Move move, const int32_t score, const int32_t depth, const TTBound bound, const uint8_t age) {
+    return uint64_t{move.move} | uint64_t{static_cast<uint16_t>(score)} << 16 | uint64_t{static_cast<uint8_t>(depth)} << 32 | uint64_t{bound} << 40 |
+           uint64_t{age} << 42;
+}
+
+static TTData tt_unpack(const uint64_t data) {
+    return TTData{Move{static_cast<Move::storage_type>(data)}, static_cast<int16_t>(data >> 16), static_cast<int8_t>(data >> 32), static_cast<TTBound>(data >> 40 & 3),
+                  static_cast<uint8_t>(data >> 42 & TranspositionTable::AGE_MASK)};
+}
+
+TranspositionTable::TranspositionTable(const uint64_t mb) { resize(mb); }
+
+void TranspositionTable::resize(const uint64_t mb) {
+    const uint64_t count = std::bit_floor(std::max<uint64_t>(mb * 1024 * 1024 / sizeof(TTBucket), 1));
+    buckets = std::make_unique<TTBucket[]>(count);
+    mask = count - 1;
+    age = 0;
+}
+
+void TranspositionTable::clear(int32_t threads) {
+    if (threads <= 0) {
+        threads = static_cast<int32_t>(std::max(std::thread::hardware_concurrency(), 1u));
+    }
+    const uint64_t count = mask + 1;
+    const uint64_t slice = (count + static_cast<uint64_t>(threads) - 1) / static_cast<uint64_t>(threads);
+    auto clear_slice = [this, count, slice](const uint64_t index) {
+        const uint64_t begin = std::min(index * slice, count);
+        const uint64_t end = std::min(begin + slice, count);
+        std::memset(static_cast<void *>(&buckets[begin]), 0, (end - begin) * sizeof(TTBucket)); // Zero is an empty entry in both words
+    };
+    gtr::vector<std::thread> workers;
+    for (int32_t i = 1; i < threads; ++i) { workers.emplace_back(clear_slice, static_cast<uint64_t>(i)); }
+    clear_slice(0);
+    for (auto &worker : workers) { worker.join(); }
+    age = 0;
+}
+
+bool TranspositionTable::probe(const uint64_t key, TTData &out) const {
+    for (const TTEntry &entry : buckets[key & mask].entries) {
+        const uint64_t data = entry.data.load(std::memory_order_relaxed);
+        if ((entry.check.load(std::memory_order_relaxed) ^ data) == key) {
+            out = tt_unpack(data);
+            return out.bound != TT_BOUND_NONE;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(const uint64_t key, Move move, const int32_t score, const int32_t depth, const TTBound bound) {
+    TTBucket &bucket = buckets[key & mask];
+    TTEntry *victim = &bucket.entries[0];
+    int32_t victim_value = INT_MAX;
+    for (TTEntry &entry : bucket.entries) {
+        const uint64_t data = entry.data.load(std::memory_order_relaxed);
+        if ((entry.check.load(std::memory_order_relaxed) ^ data) == key) {
+            const TTData old = tt_unpack(data);
+            // A deeper bound from this same search is worth more than a shallow one, an exact score always goes in
+            if (bound != TT_BOUND_EXACT && old.age == age && old.depth > depth + 2) {
+                return;
+            }
+            if (move == Move{}) {
+                move = old.move; // A fail low has no best move, keep the one found before
+            }
+            victim = &entry;
+            break;
+        }
+        const TTData old = tt_unpack(data);
+        const int32_t value = old.depth - TT_AGE_WEIGHT * ((age - old.age) & AGE_MASK);
+        if (value < victim_value) {
+            victim_value = value;
+            victim = &entry;
+        }
+    }
+    const uint64_t data = tt_pack(move, score, depth, bound, age);
+    victim->check.store(key ^ data, std::memory_order_relaxed);
+    victim->data.store(data, std::memory_order_relaxed);
+}
+} // namespace game
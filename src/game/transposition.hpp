@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "array.hpp"
+#include "move.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace game {
+// What the stored score says about the true one: at most (fail low), at least (fail high) or exactly it
+enum TTBound : uint8_t { TT_BOUND_NONE, TT_BOUND_UPPER, TT_BOUND_LOWER, TT_BOUND_EXACT };
+
+struct TTData {
+    Move move;
+    int16_t score;
+    int8_t depth;
+    TTBound bound;
+    uint8_t age;
+};
+
+/*
+ One slot. The data is packed in a single word and check holds key ^ data, so a reader that catches another thread
+ between the two stores sees a key that does not match and treats it as a miss. No locks, no torn results.
+*/
+struct TTEntry {
+    std::atomic<uint64_t> check{0};
+    std::atomic<uint64_t> data{0};
+};
+
+constexpr int32_t TT_BUCKET_ENTRIES = 4;
+
+// A bucket is one cache line, a probe touches a single line whichever entry it ends up on
+struct alignas(64) TTBucket {
+    gtr::array<TTEntry, TT_BUCKET_ENTRIES> entries;
+};
+static_assert(sizeof(TTBucket) == 64);
+
+/*
+ Shared by every search thread. A position hashes to one bucket, a store replaces the entry holding the same key or
+ else the least useful one: entries left from earlier searches first, then the shallowest.
+*/
+struct TranspositionTable {
+    static constexpr uint8_t AGE_MASK = 0x3F; // Searches are told apart modulo 64
+
+    std::unique_ptr<TTBucket[]> buckets;
+    uint64_t mask{0};
+    uint8_t age{0};
+
+    explicit TranspositionTable(uint64_t mb = 16);
+
+    // Reallocates to the largest power of two bucket count that fits, the contents are lost
+    void resize(uint64_t mb);
+
+    // Zeroes the table with one thread per slice, 0 uses every hardware thread
+    void clear(int32_t threads = 0);
+
+    // Called once per search so the entries of earlier searches get replaced first
+    void new_search() { age = static_cast<uint8_t>((age + 1) & AGE_MASK); }
+
+    bool probe(uint64_t key, TTData &out) const;
+
+    void store(uint64_t key, Move move, int32_t score, int32_t depth, TTBound bound);
+
+    // Starts loading the bucket of a key, call it right after making a move so the line is there by the time of the probe
+    void prefetch(const uint64_t key) const {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(&buckets[key & mask]);
+#elif defined(_MSC_VER)
+        _mm_prefetch(reinterpret_cast<const char *>(&buckets[key & mask]), _MM_HINT_T0);
+#endif
+    }
+
+    uint64_t size_bytes() const { return (mask + 1) * sizeof(TTBucket); }
+};
+} // namespace game
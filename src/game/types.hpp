@@ -1,6 +1,7 @@
 #pragma once
 #include "array.hpp"
 #include "math.hpp"
+#include <cstddef>
 #include <cstdint>
 #include <utility>
 #include "piece.hpp"
@@ -75,7 +76,7 @@ static constexpr gtr::array CellNamesC {"a1", "b1", "c1", "d1", "e1", "f1", "g1"
                                         "a5", "b5", "c5", "d5", "e5", "f5", "g5", "h5",
                                         "a6", "b6", "c6", "d6", "e6", "f6", "g6", "h6",
                                         "a7", "b7", "c7", "d7", "e7", "f7", "g7", "h7",
-                                        "a8", "b8", "c8", "d8", "e8", "f8", "g8"};
+                                        "a8", "b8", "c8", "d8", "e8", "f8", "g8", "h8"};
 // clang-format on
 
 constexpr int32_t square_file(const SquareIndex sq) noexcept { return static_cast<int32_t>(std::to_underlying(sq)) & 7; }
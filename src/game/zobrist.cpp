@@ -0,0 +1,26 @@
+#include "zobrist.hpp"
+#include "board.hpp"
+#include "position.hpp"
+
+namespace game {
+template <typename Pos> static uint64_t zobrist_en_passant_key(const Pos &pos, const int8_t en_passant_index, const Color side) {
+    if (en_passant_index == EN_PASSANT_INVALID_INDEX || !(MAGIC_BOARD.pawn_attackers[side][en_passant_index] & pos.get_piece_bitboard(PAWN, side))) {
+        return 0;
+    }
+    return ZOBRIST.en_passant[file_of(static_cast<SquareIndex>(en_passant_index))];
+}
+
+uint64_t zobrist_en_passant(const Board &board, const int8_t en_passant_index, const Color side) { return zobrist_en_passant_key(board, en_passant_index, side); }
+
+uint64_t zobrist_en_passant(const Position &pos, const int8_t en_passant_index, const Color side) { return zobrist_en_passant_key(pos, en_passant_index, side); }
+
+uint64_t zobrist_compute(const Board &board) {
+    uint64_t key = 0;
+    for (const auto sq : BitBoardIterator(board.pieces_by_type[ANY])) { key ^= ZOBRIST.pieces[board.pieces[sq]][sq]; }
+    if (board.side_to_move == PIECE_BLACK) {
+        key ^= ZOBRIST.side;
+    }
+    key ^= ZOBRIST.castle[std::to_underlying(board.current_state->castle_rights)];
+    return key ^ zobrist_en_passant(board, board.current_state->en_passant_index, board.side_to_move);
+}
+} // namespace game
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include "array.hpp"
+#include "piece.hpp"
+#include "random.hpp"
+#include "types.hpp"
+
+namespace game {
+struct Board;
+struct Position;
+
+struct ZobristKeys {
+    gtr::array<gtr::array<uint64_t, SQUARE_COUNT>, PIECE_CB> pieces; // Indexed by Piece, the empty slots stay zero
+    gtr::array<uint64_t, CASTLE_RIGHTS_COUNT> castle;
+    gtr::array<uint64_t, FILE_COUNT> en_passant;
+    uint64_t side;
+};
+
+constexpr ZobristKeys zobrist_generate() {
+    ZobristKeys keys{};
+    detail::RandomGenerator rng{0x9E3779B97F4A7C15ULL};
+    for (int32_t p = WHITE_PAWN; p < PIECE_CB; ++p) {
+        if (PIECE_TYPE(p) == EMPTY || PIECE_TYPE(p) > KING) {
+            continue;
+        }
+        for (auto &key : keys.pieces[p]) { key = rng(); }
+    }
+    for (auto &key : keys.castle) { key = rng(); }
+    for (auto &key : keys.en_passant) { key = rng(); }
+    keys.side = rng();
+    return keys;
+}
+
+inline constexpr ZobristKeys ZOBRIST = zobrist_generate();
+
+// Compile time choice of whether the piece mutators keep the key up to date. Every make does, undo restores the previous
+// state with its key already in it and passes KEY_NONE.
+enum KeyPolicy : uint8_t { KEY_INCREMENTAL, KEY_NONE };
+
+// Key of an en passant square for the given side to move, zero when none of its pawns can capture there
+uint64_t zobrist_en_passant(const Board &board, int8_t en_passant_index, Color side);
+uint64_t zobrist_en_passant(const Position &pos, int8_t en_passant_index, Color side);
+
+// Full recomputation from the pieces, side, castle rights and en passant square.
+// The en passant file only counts when a pawn of the side to move can actually capture there.
+uint64_t zobrist_compute(const Board &board);
+} // namespace game
@@ -0,0 +1,233 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "game/board.hpp"
+#include "game/fen.hpp"
+#include "game/movegen.hpp"
+
+/*
+ Make/unmake microbenchmarks. Every operation is timed on its own over fixed lines of play from the corpus positions,
+ the results can be saved as JSON and compared against a stored baseline, the run fails past the regression threshold.
+ A change that makes these paths slower on purpose records the new numbers with -out in the same commit and says what
+ they pay for, so the gate stays green and every step in the baseline has a reason next to it.
+*/
+static constexpr const char *BENCH_FENS[] = {
+    game::Fen::FEN_START,
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+static constexpr int32_t BENCH_POSITION_COUNT = sizeof(BENCH_FENS) / sizeof(BENCH_FENS[0]);
+static constexpr int32_t BENCH_LINE_PLIES = 32;
+
+enum BenchId : uint8_t { BENCH_BOARD_MOVE, BENCH_MOVE_STATELESS, BENCH_UNDO_STATELESS, BENCH_APPLY_MOVE, BENCH_UPDATE_RIGHTS, BENCH_BOARD_REDO, BENCH_COUNT };
+
+static constexpr gtr::array<const char *, BENCH_COUNT> BENCH_NAMES = {"board_move", "move_stateless", "undo_stateless", "apply_move", "update_rights", "board_redo"};
+
+struct BenchResult {
+    double seconds{0};
+    uint64_t ops{0};
+
+    double ns_per_op() const { return ops == 0 ? 0 : 1e9 * seconds / static_cast<double>(ops); }
+};
+
+// A fixed line of play, so every run replays the same moves
+struct BenchLine {
+    game::Board board;
+    gtr::array<game::Move, BENCH_LINE_PLIES> moves;
+    int32_t count{0};
+};
+
+// Keeps the results of the timed calls alive
+static volatile uint8_t bench_sink = 0;
+
+static void print_usage() {
+    std::printf("usage: game_bench [-iterations n] [-out file] [-baseline file] [-no-baseline] [-threshold percent]\n"
+                "  Times Board::move, move_stateless, undo_stateless, board_apply_move, board_update_rights and Board::redo\n"
+                "  over fixed lines of play, then compares every result against the baseline.\n"
+                "  -iterations n       replays of every line (default 20000)\n"
+                "  -out file           write the results as JSON, use it to refresh the baseline\n"
+                "  -baseline file      baseline to compare against (default %s)\n"
+                "  -no-baseline        only measure\n"
+                "  -threshold percent  slowdown that counts as a regression (default 25)\n",
+                GAME_BENCH_BASELINE);
+}
+
+static double bench_seconds_since(const std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void bench_build_line(const char *fen_string, BenchLine &line) {
+    game::Fen fen;
+    fen.set_fen(fen_string);
+    line.board.set_position(fen);
+    game::Board walker = line.board;
+    game::MoveList list;
+    for (line.count = 0; line.count < BENCH_LINE_PLIES; ++line.count) {
+        game::generate_legal_moves(walker, list);
+        if (list.empty()) {
+            break;
+        }
+        // Deterministic but spread over the list, so captures, castles and promotions all show up
+        const game::Move move = list[(line.count * 7 + 3) % list.size()];
+        line.moves[line.count] = move;
+        walker.move(move);
+    }
+}
+
+static void bench_run(BenchLine &line, gtr::array<BenchResult, BENCH_COUNT> &results) {
+    game::Board &board = line.board;
+    const int32_t n = line.count;
+    gtr::array<game::BoardState, BENCH_LINE_PLIES> states;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < n; ++i) { board.move(line.moves[i]); }
+    results[BENCH_BOARD_MOVE].seconds += bench_seconds_since(start);
+    for (int32_t i = 0; i < n; ++i) { board.undo(); }
+    start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < n; ++i) { board.redo(); }
+    results[BENCH_BOARD_REDO].seconds += bench_seconds_since(start);
+    for (int32_t i = 0; i < n; ++i) { board.undo(); }
+
+    start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < n; ++i) { board.move_stateless(line.moves[i], states[i]); }
+    results[BENCH_MOVE_STATELESS].seconds += bench_seconds_since(start);
+    start = std::chrono::steady_clock::now();
+    for (int32_t i = n - 1; i >= 0; --i) { board.undo_stateless(states[i]); }
+    results[BENCH_UNDO_STATELESS].seconds += bench_seconds_since(start);
+
+    // The states are linked up front, the timed loop only inherits the previous rights and key like move_stateless does.
+    // undo_stateless restores the board afterwards.
+    game::BoardState *const root = board.current_state;
+    for (int32_t i = 0; i < n; ++i) {
+        states[i].last_move = line.moves[i];
+        states[i].previous = i == 0 ? root : &states[i - 1];
+    }
+    start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < n; ++i) {
+        const game::BoardState *const previous = board.current_state;
+        states[i].castle_rights = previous->castle_rights;
+        states[i].castle_rights_bit = previous->castle_rights_bit;
+        states[i].en_passant_index = previous->en_passant_index;
+        states[i].key = previous->key;
+        board.current_state = &states[i];
+        game::board_apply_move(board, line.moves[i], states[i]);
+        board.side_to_move = ~board.side_to_move;
+    }
+    results[BENCH_APPLY_MOVE].seconds += bench_seconds_since(start);
+    for (int32_t i = n - 1; i >= 0; --i) {
+        board.move_count++; // board_apply_move leaves the move count alone, undo_stateless decrements it
+        board.undo_stateless(states[i]);
+    }
+
+    game::BoardState rights = *board.current_state;
+    start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < n; ++i) { game::board_update_rights(rights, line.moves[i].get_origin_index(), line.moves[i].get_destination_index()); }
+    results[BENCH_UPDATE_RIGHTS].seconds += bench_seconds_since(start);
+    bench_sink = bench_sink ^ std::to_integer<uint8_t>(rights.castle_rights);
+
+    for (auto &result : results) { result.ops += static_cast<uint64_t>(n); }
+}
+
+static bool bench_write_json(const char *path, const gtr::array<BenchResult, BENCH_COUNT> &results, const int32_t iterations) {
+    FILE *f = std::fopen(path, "w");
+    if (f == nullptr) {
+        std::printf("game_bench: cannot open '%s'\n", path);
+        return false;
+    }
+    std::fprintf(f, "{\n  \"iterations\": %d,\n  \"benchmarks\": [\n", iterations);
+    for (int32_t b = 0; b < BENCH_COUNT; ++b) {
+        std::fprintf(f, "    {\"name\": \"%s\", \"ns_per_op\": %.3f, \"ops\": %llu}%s\n", BENCH_NAMES[b], results[b].ns_per_op(),
+                     static_cast<unsigned long long>(results[b].ops), b + 1 < BENCH_COUNT ? "," : "");
+    }
+    std::fputs("  ]\n}\n", f);
+    std::fclose(f);
+    return true;
+}
+
+// Reads back what bench_write_json writes: the ns_per_op following each known name, -1 when a name is missing
+static bool bench_read_baseline(const char *path, gtr::array<double, BENCH_COUNT> &baseline) {
+    FILE *f = std::fopen(path, "rb");
+    if (f == nullptr) {
+        return false;
+    }
+    static char text[16 * 1024];
+    const size_t size = std::fread(text, 1, sizeof(text) - 1, f);
+    std::fclose(f);
+    text[size] = '\0';
+
+    for (int32_t b = 0; b < BENCH_COUNT; ++b) {
+        baseline[b] = -1;
+        char key[64];
+        std::snprintf(key, sizeof(key), "\"name\": \"%s\"", BENCH_NAMES[b]);
+        const char *entry = std::strstr(text, key);
+        const char *value = entry != nullptr ? std::strstr(entry, "\"ns_per_op\":") : nullptr;
+        if (value != nullptr) {
+            baseline[b] = std::strtod(value + std::strlen("\"ns_per_op\":"), nullptr);
+        }
+    }
+    return true;
+}
+
+int main(const int argc, char **argv) {
+    int32_t iterations = 20000;
+    double threshold = 25.0;
+    const char *out_path = nullptr;
+    const char *baseline_path = GAME_BENCH_BASELINE;
+    for (int32_t i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-iterations") == 0 && i + 1 < argc) {
+            iterations = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "-out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (std::strcmp(argv[i], "-baseline") == 0 && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else if (std::strcmp(argv[i], "-no-baseline") == 0) {
+            baseline_path = nullptr;
+        } else if (std::strcmp(argv[i], "-threshold") == 0 && i + 1 < argc) {
+            threshold = std::atof(argv[++i]);
+        } else {
+            print_usage();
+            return std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    static BenchLine lines[BENCH_POSITION_COUNT];
+    for (int32_t i = 0; i < BENCH_POSITION_COUNT; ++i) { bench_build_line(BENCH_FENS[i], lines[i]); }
+
+    gtr::array<BenchResult, BENCH_COUNT> results{};
+    for (int32_t it = 0; it < iterations; ++it) {
+        for (auto &line : lines) { bench_run(line, results); }
+    }
+
+    gtr::array<double, BENCH_COUNT> baseline{};
+    const bool has_baseline = baseline_path != nullptr && bench_read_baseline(baseline_path, baseline);
+    if (baseline_path != nullptr && !has_baseline) {
+        std::printf("game_bench: no baseline at '%s', only measuring\n", baseline_path);
+    }
+
+    bool regressed = false;
+    std::printf("%-16s %12s %14s %10s\n", "benchmark", "ns/op", "baseline ns/op", "change");
+    for (int32_t b = 0; b < BENCH_COUNT; ++b) {
+        const double ns = results[b].ns_per_op();
+        if (!has_baseline || baseline[b] <= 0) {
+            std::printf("%-16s %12.2f %14s %10s\n", BENCH_NAMES[b], ns, "-", "-");
+            continue;
+        }
+        const double change = 100.0 * (ns - baseline[b]) / baseline[b];
+        const bool slower = change > threshold;
+        regressed = regressed || slower;
+        std::printf("%-16s %12.2f %14.2f %+9.1f%%%s\n", BENCH_NAMES[b], ns, baseline[b], change, slower ? "  REGRESSION" : "");
+    }
+
+    if (out_path != nullptr && !bench_write_json(out_path, results, iterations)) {
+        return 1;
+    }
+    if (regressed) {
+        std::printf("game_bench: regression past %.1f%% against %s\n", threshold, baseline_path);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "game/board.hpp"
+#include "game/fen.hpp"
+#include "game/perft.hpp"
+
+static void print_usage() {
+    std::printf("usage: perft <depth> [fen] [-threads n] [-hash mb] [-copymake]\n"
+                "  Counts the leaf nodes of the move tree rooted at fen (start position by default),\n"
+                "  printing the count below each root move and the total nodes per second.\n"
+                "  -threads n  split the tree across n work-stealing threads (default 1)\n"
+                "  -hash mb    share a transposition table of that many megabytes between threads (default 0, off)\n"
+                "  -copymake   walk the tree by copying a Position per node instead of make/unmake on the Board\n");
+}
+
+int main(const int argc, char **argv) {
+    if (argc < 2 || std::strcmp(argv[1], "-h") == 0 || std::strcmp(argv[1], "--help") == 0) {
+        print_usage();
+        return argc < 2 ? 1 : 0;
+    }
+    const int32_t depth = std::atoi(argv[1]);
+    if (depth < 1) {
+        std::printf("perft: depth must be at least 1\n");
+        return 1;
+    }
+
+    const char *fen_string = game::Fen::FEN_START;
+    game::PerftOptions options;
+    bool copy_make = false;
+    for (int32_t i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-threads") == 0 && i + 1 < argc) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "-hash") == 0 && i + 1 < argc) {
+            options.hash_mb = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "-copymake") == 0) {
+            copy_make = true;
+        } else if (argv[i][0] != '-') {
+            fen_string = argv[i];
+        } else {
+            std::printf("perft: unknown option '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+
+    game::Fen fen;
+    if (!fen.set_fen(fen_string)) {
+        std::printf("perft: invalid fen '%s'\n", fen_string);
+        return 1;
+    }
+    game::Board board;
+    board.set_position(fen);
+
+    const auto start = std::chrono::steady_clock::now();
+    game::PerftDivide divide;
+    if (copy_make) {
+        game::perft_divide(game::position_from_board(board), depth, divide);
+    } else if (options.threads > 1 || options.hash_mb > 0) {
+        game::perft_parallel(board, depth, options, divide);
+    } else {
+        game::perft_divide(board, depth, divide);
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (int32_t i = 0; i < divide.moves.size(); ++i) {
+        std::printf("%s: %llu\n", game::move_to_uci(divide.moves[i]).c_str(), static_cast<unsigned long long>(divide.nodes[i]));
+    }
+    std::printf("\nMoves: %d\nNodes: %llu\nTime: %.3fs\nNPS: %.0f\n", divide.moves.size(), static_cast<unsigned long long>(divide.total), elapsed,
+                elapsed > 0.0 ? static_cast<double>(divide.total) / elapsed : 0.0);
+    return 0;
+}
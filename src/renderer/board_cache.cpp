@@ -0,0 +1,59 @@
+#include "board_cache.hpp"
+#include <cstdio>
+#include "../game/movegen.hpp"
+
+namespace renderer {
+void board_cache_update(BoardCache &cache, const game::Game &game) {
+    const game::Board &board = game.board;
+    if (cache.version != board.version) {
+        cache.version = board.version;
+        // One legal generation feeds both the count and every piece's destinations
+        game::MoveList list;
+        game::generate_legal_moves(board, list);
+        cache.legal_move_count = static_cast<int32_t>(list.size());
+        for (int32_t sq = 0; sq < game::SQUARE_COUNT; ++sq) { cache.available_moves[sq] = game::AvailableMoves(sq); }
+        for (const auto move : list) { game::bitboard_set(cache.available_moves[move.get_origin_index()].bits, move.get_destination_index()); }
+    }
+    if (cache.status != game.status || cache.winner != game.winner || cache.status_text.empty()) {
+        cache.status = game.status;
+        cache.winner = game.winner;
+        char text[128];
+        std::snprintf(text, sizeof(text), "Status %s (%s)", game.get_status_string(), game.get_winner_string());
+        cache.status_text = text;
+    }
+}
+
+void board_cache_update_debug(BoardCache &cache, const game::Board &board) {
+    if (cache.debug_version == board.version) {
+        return;
+    }
+    cache.debug_version = board.version;
+    cache.board_string = board.board_to_string();
+    for (int32_t i = 0; i < game::PIECE_COUNT_PLUS_ANY; ++i) { cache.type_bitboards[i] = game::print_bitboard(board.pieces_by_type[i]); }
+    for (int32_t i = 0; i < game::COLOR_COUNT; ++i) { cache.color_bitboards[i] = game::print_bitboard(board.pieces_by_color[i]); }
+}
+
+void board_cache_update_magic(BoardCache &cache, const int32_t magic_board, const int32_t square) {
+    if (cache.magic_board == magic_board && cache.magic_square == square) {
+        return;
+    }
+    cache.magic_board = magic_board;
+    cache.magic_square = square;
+    const auto &mb = game::MAGIC_BOARD;
+    game::BitBoard first = 0;
+    game::BitBoard second = 0;
+    switch (magic_board) {
+    case 0: first = mb.pawn_attacks[0][square]; second = mb.pawn_attacks[1][square]; break;
+    case 1: first = mb.knight_attacks[square]; break;
+    case 2: first = mb.king_attacks[square]; break;
+    case 3: first = mb.pawn_attackers[0][square]; second = mb.pawn_attackers[1][square]; break;
+    case 4: first = mb.knight_attackers[square]; break;
+    case 5: first = mb.king_attackers[square]; break;
+    case 6: first = mb.rook_mask[square]; break;
+    case 7: first = mb.bishop_mask[square]; break;
+    default: break;
+    }
+    cache.magic_bitboards[0] = game::print_bitboard(first);
+    cache.magic_bitboards[1] = game::print_bitboard(second);
+}
+} // namespace renderer
@@ -0,0 +1,30 @@
+#pragma once
+#include "../game/game.hpp"
+
+namespace renderer {
+// What the panels derive from the position, rebuilt only when Board::version moves instead of every frame.
+// A version of 0 means never built, boards start at 1.
+struct BoardCache {
+    uint64_t version{0};
+    uint64_t debug_version{0};
+    int32_t legal_move_count{0};
+    gtr::array<game::AvailableMoves, game::SQUARE_COUNT> available_moves{}; // Legal destinations of the side to move's pieces
+    game::Game::GameStatus status{game::Game::GameStatus::INVALID};
+    game::Game::GameWinner winner{game::Game::GameWinner::PLAYING};
+    gtr::large_string status_text;
+
+    // Debug window strings, only built while it is open
+    gtr::large_string board_string;
+    gtr::array<gtr::large_string, game::PIECE_COUNT_PLUS_ANY> type_bitboards;
+    gtr::array<gtr::large_string, game::COLOR_COUNT> color_bitboards;
+    int32_t magic_board{-1};
+    int32_t magic_square{-1};
+    gtr::array<gtr::large_string, 2> magic_bitboards; // Second one only for the tables with a white and a black side
+};
+
+void board_cache_update(BoardCache &cache, const game::Game &game);
+
+void board_cache_update_debug(BoardCache &cache, const game::Board &board);
+
+void board_cache_update_magic(BoardCache &cache, int32_t magic_board, int32_t square);
+} // namespace renderer
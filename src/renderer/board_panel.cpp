@@ -64,13 +64,15 @@ BoardPanel::BoardPanel() {
 }
 
 static void render_debug_info(BoardPanel *panel) {
+    BoardCache &cache = panel->cache;
+    board_cache_update_debug(cache, panel->chess_game.board);
     ImGui::Checkbox("View as plain string", &panel->debug_plain_string);
     if (panel->debug_plain_string) {
-        ImGui::TextUnformatted(panel->chess_game.board.board_to_string().c_str());
+        ImGui::TextUnformatted(cache.board_string.c_str());
     } else {
         constexpr float piece_font_size = 30.0f;
         ImGui::PushFont(ImGui::GetIO().Fonts->Fonts[0], piece_font_size);
-        ImGui::TextUnformatted(panel->chess_game.board.board_to_string().c_str());
+        ImGui::TextUnformatted(cache.board_string.c_str());
         ImGui::PopFont();
     }
     ImGui::Begin("Board BitBoards");
@@ -81,7 +83,7 @@ static void render_debug_info(BoardPanel *panel) {
         for (int i = 0; i < game::PIECE_COUNT_PLUS_ANY; ++i) {
             ImGui::TableNextColumn();
             ImGui::TextUnformatted(game::piece_type_to_string(static_cast<game::PieceType>(i)));
-            ImGui::TextUnformatted(game::print_bitboard(panel->chess_game.board.pieces_by_type[i]).c_str());
+            ImGui::TextUnformatted(cache.type_bitboards[i].c_str());
         }
         ImGui::EndTable();
     }
@@ -92,7 +94,7 @@ static void render_debug_info(BoardPanel *panel) {
         for (int i = 0; i < game::COLOR_COUNT; ++i) {
             ImGui::TableNextColumn();
             ImGui::TextUnformatted(game::color_to_string(static_cast<game::Color>(i)));
-            ImGui::TextUnformatted(game::print_bitboard(panel->chess_game.board.pieces_by_color[i]).c_str());
+            ImGui::TextUnformatted(cache.color_bitboards[i].c_str());
         }
         ImGui::EndTable();
     }
@@ -101,52 +103,53 @@ static void render_debug_info(BoardPanel *panel) {
 
     static constexpr std::array magic_boards_names = {"Pawn Attacks",     "Knight Attacks", "King Attacks", "Pawn Attackers",
                                                       "Knight Attackers", "King Attackers", "Rook Mask",    "Bishop Mask"};
+    static constexpr std::array magic_boards_titles = {"Pawn Attacks(White/Black)", "Knight Attacks",   "King Attacks", "Pawn Attackers(White/Black)",
+                                                       "Knight Attackers",          "King Attackers",   "Rook Mask",    "Bishop Mask"};
     ImGui::Combo("###Table", &panel->selected_magic_board, magic_boards_names.data(), static_cast<int32_t>(magic_boards_names.size()));
 
     ImGui::Combo("###Square", &panel->selected_square, game::CellNamesC.data(), static_cast<int32_t>(game::CellNamesC.size()));
-    switch (panel->selected_magic_board) {
-    case 0: // Pawn Attacks
-        ImGui::TextUnformatted("Pawn Attacks(White/Black)");
-        ImGui::TextUnformatted(game::print_bitboard(game::MAGIC_BOARD.pawn_attacks[0][panel->selected_square]).c_str());
-        ImGui::SameLine();
-        ImGui::TextUnformatted(game::print_bitboard(game::MAGIC_BOARD.pawn_attacks[1][panel->selected_square]).c_str());
-        break;
-    case 1: // Knight Attacks
-        ImGui::TextUnformatted("Knight Attacks");
-        ImGui::TextUnformatted(game::print_bitboard(game::MAGIC_BOARD.knight_attacks[panel->selected_square]).c_str());
-        break;
-    case 2: // King Attacks
-        ImGui::TextUnformatted("King Attacks");
-        ImGui::TextUnformatted(game::print_bitboard(game::MAGIC_BOARD.king_attacks[panel->selected_square]).c_str());
-        break;
-    case 3: // Pawn Attacks
-        ImGui::TextUnformatted("Pawn Attackers(White/Black)");
-        ImGui::TextUnformatted(game::print_bitboard(game::MAGIC_BOARD.pawn_attackers[0][panel->selected_square]).c_str());
-        ImGui::SameLine();
-        ImGui::TextUnformatted(game::print_bitboard(game::MAGIC_BOARD.pawn_attackers[1][panel->selected_square]).c_str());
-        break;
-    case 4: // Knight Attacks
-        ImGui::TextUnformatted("Knight Attackers");
-        ImGui::TextUnformatted(game::print_bitboard(game::MAGIC_BOARD.knight_attackers[panel->selected_square]).c_str());
-        break;
-    case 5: // King Attacks
-        ImGui::TextUnformatted("King Attackers");
-        ImGui::TextUnformatted(game::print_bitboard(game::MAGIC_BOARD.king_attackers[panel->selected_square]).c_str());
-        break;
-    case 6: // Rook Mask
-        ImGui::TextUnformatted("Rook Mask");
-        ImGui::TextUnformatted(game::print_bitboard(game::MAGIC_BOARD.rook_mask[panel->selected_square]).c_str());
-        break;
-    case 7: // Bishop Mask
-        ImGui::TextUnformatted("Bishop Mask");
-        ImGui::TextUnformatted(game::print_bitboard(game::MAGIC_BOARD.bishop_mask[panel->selected_square]).c_str());
-        break;
-    default: ImGui::TextUnformatted("Unknown Magic Board"); break;
+    if (panel->selected_magic_board < 0 || panel->selected_magic_board >= static_cast<int32_t>(magic_boards_titles.size())) {
+        ImGui::TextUnformatted("Unknown Magic Board");
+    } else {
+        board_cache_update_magic(cache, panel->selected_magic_board, panel->selected_square);
+        ImGui::TextUnformatted(magic_boards_titles[panel->selected_magic_board]);
+        ImGui::TextUnformatted(cache.magic_bitboards[0].c_str());
+        // Pawn tables have a white and a black side
+        if (panel->selected_magic_board == 0 || panel->selected_magic_board == 3) {
+            ImGui::SameLine();
+            ImGui::TextUnformatted(cache.magic_bitboards[1].c_str());
+        }
     }
     ImGui::End();
 
     render_profiler();
 }
+// Who plays each side, an engine side moves on its own from Game::tick
+static void render_player_select(game::Game &chess_game, const game::Color c) {
+    static constexpr std::array player_names = {"Human", "Drunk Man", "Searcher"};
+    const game::Player &player = c == game::PIECE_WHITE ? chess_game.white_player : chess_game.black_player;
+    int32_t selected = static_cast<int32_t>(player.index());
+    ImGui::SetNextItemWidth(120.0f);
+    if (ImGui::Combo(game::color_to_string(c), &selected, player_names.data(), static_cast<int32_t>(player_names.size()))) {
+        switch (selected) {
+        case 1 : chess_game.set_player(c, game::DrunkMan{}); break;
+        case 2 : chess_game.set_player(c, game::Searcher{}); break;
+        default: chess_game.set_player(c, game::Human{}); break;
+        }
+    }
+}
+
+// Report of the side's last finished search, nothing until a Searcher has moved
+static void render_search_info(const game::Game &chess_game, const game::Color c) {
+    const game::Player &player = c == game::PIECE_WHITE ? chess_game.white_player : chess_game.black_player;
+    const auto *searcher = std::get_if<game::Searcher>(&player);
+    if (searcher == nullptr || searcher->last_search.depth == 0) {
+        return;
+    }
+    const game::SearchResult &result = searcher->last_search;
+    ImGui::Text("%s search depth %d score %d nps %llu", game::color_to_string(c), result.depth, result.score, static_cast<unsigned long long>(result.nps()));
+}
+
 extern int toggle_fullscreen();
 void BoardPanel::render() {
     ImGui::SetNextWindowSize(ImVec2(1080, 1080), ImGuiCond_FirstUseEver);
@@ -156,7 +159,8 @@ void BoardPanel::render() {
         ImGui::BeginChild("Chess Board");
         const float width = ImGui::GetWindowWidth();
         const float height = ImGui::GetWindowHeight();
-        chess_board.render(&chess_game, width, height);
+        board_cache_update(cache, chess_game);
+        chess_board.render(&chess_game, cache, width, height);
         chess_game.tick();
         ImGui::EndChild();
     }
@@ -181,12 +185,15 @@ void BoardPanel::render() {
             ImGui::Text("Dragging None");
         }
 
+        // tick may have moved since the board was drawn
+        board_cache_update(cache, chess_game);
         ImGui::Text("Move count %d", chess_game.board.move_count);
-#if 1
-        ImGui::Text("Legal move count %d", game::analyzer_get_legal_move_count(&chess_game.board, chess_game.board.side_to_move));
-#endif
-
-        ImGui::Text("Status %s (%s)", chess_game.get_status_string(), chess_game.get_winner_string());
+        render_search_info(chess_game, game::PIECE_WHITE);
+        render_search_info(chess_game, game::PIECE_BLACK);
+        ImGui::Text("Legal move count %d", cache.legal_move_count);
+        ImGui::TextUnformatted(cache.status_text.c_str());
+        render_player_select(chess_game, game::PIECE_WHITE);
+        render_player_select(chess_game, game::PIECE_BLACK);
 
         ImGui::EndChild();
         ImGui::BeginChild("Control Buttons", ImVec2(0, 0), ImGuiChildFlags_AutoResizeY);
@@ -1,10 +1,12 @@
 #pragma once
 #include "../game/game.hpp"
+#include "board_cache.hpp"
 #include "visual_board.hpp"
 namespace renderer {
 struct BoardPanel {
     VisualBoard chess_board{};
     game::Game chess_game{};
+    BoardCache cache{};
     bool debug_chess_board{false};
     bool debug_plain_string{false};
     int32_t selected_magic_board{0};
@@ -2,8 +2,6 @@
 #include <cstdint>
 #include "imgui.h"
 #include "profiler.hpp"
-gtr::profiler::profiler gtr::profiler::GlobalProfiler;
-uint32_t gtr::profiler::GlobalProfilerParent;
 namespace renderer {
 void render_profiler() {
     ImGui::Begin("Profiler", nullptr);
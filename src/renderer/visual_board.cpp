@@ -173,7 +173,7 @@ static void render_promotion_modal(game::Game *game, VisualBoard *board) {
     }
 }
 
-static void render_chess_board(game::Game *game, VisualBoard *board) {
+static void render_chess_board(game::Game *game, const BoardCache &cache, VisualBoard *board) {
     const ImVec2 global_offset = apply_window_offset(board->board_offset);
     ImGui::SetCursorPos(ImVec2(board->board_offset.x, board->board_offset.y));
     // Grab the whole region so the window itself won't drag
@@ -218,7 +218,7 @@ static void render_chess_board(game::Game *game, VisualBoard *board) {
             if (ImGui::IsItemClicked(ImGuiMouseButton_Left) && board->dragging_piece_index == -1 && game->board.pieces[index] != game::PIECE_NONE &&
                 game->board.get_color(index) == game->board.side_to_move) {
                 board->dragging_piece_index = index;
-                board->available_squares_for_dragging = game::analyzer_get_legal_moves_for_piece(&game->board, game::Board::get_row(index), game::Board::get_col(index));
+                board->available_squares_for_dragging = cache.available_moves[index];
                 ImGui::SetMouseCursor(ImGuiMouseCursor_Hand);
             } else if (board->dragging_piece_index != -1 && ImGui::IsMouseReleased(ImGuiMouseButton_Left) && ImGui::IsItemHovered()) {
                 visual_board_piece_move(board, game, game::Board::get_row(board->dragging_piece_index), game::Board::get_col(board->dragging_piece_index), flipped_rank,
@@ -280,9 +280,9 @@ static void render_selected_squares(const VisualBoard *board) {
     ImGui::GetWindowDrawList()->AddLine(from_rect.center(), to_rect.center(), IM_COL32(255, 0, 0, 255), 2.0f);
 }
 
-void VisualBoard::render(game::Game *game, const float width, const float height) {
+void VisualBoard::render(game::Game *game, const BoardCache &cache, const float width, const float height) {
     resize(this, width, height);
-    render_chess_board(game, this);
+    render_chess_board(game, cache, this);
     render_selected_squares(this);
     render_chess_pieces(game, this);
     render_dragging_piece(game, this);
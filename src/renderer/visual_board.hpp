@@ -1,5 +1,6 @@
 #pragma once
 #include "../game/board.hpp"
+#include "board_cache.hpp"
 #include "imgui_extra.hpp"
 #include "vec2.hpp"
 #include "vector.hpp"
@@ -31,7 +32,8 @@ struct VisualBoard {
     gtr::vector<Arrow> arrows{};
     game::BitBoard selected_squares_bitboard{};
 
-    void render(game::Game *game, float width, float height);
+    // Drag targets come from the cache, which must be up to date with the game's board
+    void render(game::Game *game, const BoardCache &cache, float width, float height);
     void flip_board() { flipped = !flipped; }
     void clear_arrows() { arrows.clear(); }
 };
@@ -0,0 +1,177 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_set>
+#include "game/analyzer.hpp"
+#include "game/bitboard.hpp"
+#include "game/board.hpp"
+#include "game/fen.hpp"
+#include "game/movegen.hpp"
+#include "game/perft.hpp"
+
+static constexpr const char *BENCH_FENS[] = {
+    game::Fen::FEN_START,
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+static constexpr int32_t BENCH_POSITION_COUNT = sizeof(BENCH_FENS) / sizeof(BENCH_FENS[0]);
+
+static void print_usage() {
+    std::printf("usage: slider_bench [-iterations n] [-depth d]\n"
+                "  Times analyzer_get_pseudo_legal_moves_for_piece and perft with every slider backend the CPU supports,\n"
+                "  after a report of the memory each table layout touches.\n"
+                "  -iterations n  passes over every piece of the bench positions (default 20000)\n"
+                "  -depth d       perft depth for each bench position (default 4)\n");
+}
+
+static double bench_seconds_since(const std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+using CacheLines = std::unordered_set<uintptr_t>;
+
+static void footprint_touch(CacheLines &lines, const void *address, const size_t size) {
+    const auto first = reinterpret_cast<uintptr_t>(address) / 64;
+    const auto last = (reinterpret_cast<uintptr_t>(address) + size - 1) / 64;
+    for (uintptr_t line = first; line <= last; ++line) { lines.insert(line); }
+}
+
+// Records every load a lookup makes in the given layout, mirroring MagicBoards::slider_attacks
+template <class Masks, class Magics, class Shifts, class Offsets, class Indexes, class Unique, class Direct, class Pext>
+static void footprint_lookup(const game::SliderBackend backend, const game::BitBoard occ, const game::SquareIndex sq, const Masks &mask, const Magics &magic,
+                             const Shifts &shift, const Offsets &offset, const Indexes &indexes, const Unique &unique, const Direct &direct, const Pext &pext,
+                             CacheLines &lines) {
+    footprint_touch(lines, &mask[sq], sizeof(mask[sq]));
+    footprint_touch(lines, &offset[sq], sizeof(offset[sq]));
+    if (backend == game::SLIDER_PEXT) {
+        footprint_touch(lines, &pext[offset[sq] + game::bitboard_pext(occ, mask[sq])], sizeof(pext[0]));
+        return;
+    }
+    footprint_touch(lines, &magic[sq], sizeof(magic[sq]));
+    footprint_touch(lines, &shift[sq], sizeof(shift[sq]));
+    const uint64_t index = offset[sq] + ((occ & mask[sq]) * magic[sq] >> shift[sq]);
+    if (backend == game::SLIDER_MAGIC_DIRECT) {
+        footprint_touch(lines, &direct[index], sizeof(direct[0]));
+    } else {
+        footprint_touch(lines, &indexes[index], sizeof(indexes[0]));
+        footprint_touch(lines, &unique[indexes[index]], sizeof(unique[0]));
+    }
+}
+
+static void footprint_walk(game::Board &board, const int32_t depth, const game::SliderBackend backend, CacheLines &lines, uint64_t &lookups) {
+    const auto &mb = game::MAGIC_BOARD;
+    const game::BitBoard occ = board.pieces_by_type[game::ANY];
+    const game::BitBoard queens = board.pieces_by_type[game::QUEEN];
+    for (const auto sq : game::BitBoardIterator(board.pieces_by_type[game::ROOK] | queens)) {
+        footprint_lookup(backend, occ, sq, mb.rook_mask, mb.rook_magic, mb.rook_shift, mb.rook_offset, mb.rook_unique_indexes, mb.rook_unique_table, mb.rook_direct_table,
+                         mb.rook_pext_table, lines);
+        ++lookups;
+    }
+    for (const auto sq : game::BitBoardIterator(board.pieces_by_type[game::BISHOP] | queens)) {
+        footprint_lookup(backend, occ, sq, mb.bishop_mask, mb.bishop_magic, mb.bishop_shift, mb.bishop_offset, mb.bishop_unique_indexes, mb.bishop_unique_table,
+                         mb.bishop_direct_table, mb.bishop_pext_table, lines);
+        ++lookups;
+    }
+    if (depth == 0) {
+        return;
+    }
+    game::MoveList list;
+    game::generate_legal_moves(board, list);
+    for (const auto move : list) {
+        game::BoardState state{};
+        board.move_stateless(move, state);
+        footprint_walk(board, depth - 1, backend, lines, lookups);
+        board.undo_stateless(state);
+    }
+}
+
+static void footprint_report(game::Board *boards) {
+    const auto &mb = game::MAGIC_BOARD;
+    // Bytes loaded by one rook lookup, the bishop tables use the same element types
+    static constexpr gtr::array bytes_per_lookup = {
+        sizeof(mb.rook_mask[0]) + sizeof(mb.rook_magic[0]) + sizeof(mb.rook_shift[0]) + sizeof(mb.rook_offset[0]) + sizeof(mb.rook_unique_indexes[0]) + sizeof(mb.rook_unique_table[0]),
+        sizeof(mb.rook_mask[0]) + sizeof(mb.rook_magic[0]) + sizeof(mb.rook_shift[0]) + sizeof(mb.rook_offset[0]) + sizeof(mb.rook_direct_table[0]),
+        sizeof(mb.rook_mask[0]) + sizeof(mb.rook_offset[0]) + sizeof(mb.rook_pext_table[0]),
+    };
+    static constexpr gtr::array dependent_loads = {2, 1, 1};
+    const gtr::array table_bytes = {
+        sizeof(mb.rook_unique_indexes) + sizeof(mb.rook_unique_table) + sizeof(mb.bishop_unique_indexes) + sizeof(mb.bishop_unique_table),
+        sizeof(mb.rook_direct_table) + sizeof(mb.bishop_direct_table),
+        sizeof(mb.rook_pext_table) + sizeof(mb.bishop_pext_table),
+    };
+
+    std::printf("%-8s %16s %16s %12s %18s %10s\n", "layout", "bytes per lookup", "dependent loads", "table KB", "lines touched (KB)", "lookups");
+    for (int32_t b = 0; b < game::SLIDER_BACKEND_COUNT; ++b) {
+        const auto backend = static_cast<game::SliderBackend>(b);
+        CacheLines lines;
+        uint64_t lookups = 0;
+        if (backend != game::SLIDER_PEXT || game::cpu_has_fast_pext()) {
+            for (int32_t i = 0; i < BENCH_POSITION_COUNT; ++i) { footprint_walk(boards[i], 3, backend, lines, lookups); }
+        }
+        std::printf("%-8s %16zu %16d %12zu %18zu %10llu\n", game::slider_backend_to_string(backend), bytes_per_lookup[b], dependent_loads[b], table_bytes[b] / 1024,
+                    lines.size() * 64 / 1024, static_cast<unsigned long long>(lookups));
+    }
+    std::printf("(lines touched: distinct 64 byte lines read by the slider lookups of a depth 3 walk over the bench positions)\n\n");
+}
+
+int main(const int argc, char **argv) {
+    int32_t iterations = 20000;
+    int32_t depth = 4;
+    for (int32_t i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-iterations") == 0 && i + 1 < argc) {
+            iterations = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "-depth") == 0 && i + 1 < argc) {
+            depth = std::atoi(argv[++i]);
+        } else {
+            print_usage();
+            return std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    game::Board boards[BENCH_POSITION_COUNT];
+    for (int32_t i = 0; i < BENCH_POSITION_COUNT; ++i) {
+        game::Fen fen;
+        fen.set_fen(BENCH_FENS[i]);
+        boards[i].set_position(fen);
+    }
+
+    footprint_report(boards);
+
+    const game::SliderBackend startup_backend = game::slider_backend;
+    std::printf("startup backend: %s\n\n", game::slider_backend_to_string(startup_backend));
+    std::printf("%-8s %22s %16s %16s\n", "backend", "pseudo legal ns/call", "perft nodes", "perft nps");
+    for (int32_t b = 0; b < game::SLIDER_BACKEND_COUNT; ++b) {
+        const auto backend = static_cast<game::SliderBackend>(b);
+        if (!game::slider_set_backend(backend)) {
+            std::printf("%-8s %22s\n", game::slider_backend_to_string(backend), "unsupported on this CPU");
+            continue;
+        }
+
+        uint64_t checksum = 0;
+        int64_t calls = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int32_t it = 0; it < iterations; ++it) {
+            for (const auto &board : boards) {
+                for (const auto sq : game::BitBoardIterator(board.pieces_by_type[game::ANY])) {
+                    checksum += game::analyzer_get_pseudo_legal_moves_for_piece(&board, sq).bits;
+                    ++calls;
+                }
+            }
+        }
+        const double pseudo_seconds = bench_seconds_since(start);
+
+        uint64_t nodes = 0;
+        start = std::chrono::steady_clock::now();
+        for (auto &board : boards) { nodes += game::perft(board, depth); }
+        const double perft_seconds = bench_seconds_since(start);
+
+        std::printf("%-8s %22.2f %16llu %16.0f   (checksum %016llx)\n", game::slider_backend_to_string(backend), 1e9 * pseudo_seconds / static_cast<double>(calls),
+                    static_cast<unsigned long long>(nodes), static_cast<double>(nodes) / perft_seconds, static_cast<unsigned long long>(checksum));
+    }
+    game::slider_set_backend(startup_backend);
+    return 0;
+}